@@ -0,0 +1,334 @@
+// printpipe_bench: microbenchmarks for the core hot paths.
+//
+//   printpipe_bench                         human-readable table
+//   printpipe_bench --json > v0.1.0.json    machine-readable results
+//   printpipe_bench --baseline v0.1.0.json  fail on >10% slowdowns
+
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "harness.hpp"
+#include "printpipe/event_bus.hpp"
+#include "printpipe/file_backend.hpp"
+#include "printpipe/job.hpp"
+#include "printpipe/json_writer.hpp"
+#include "printpipe/scheduler.hpp"
+#include "printpipe/spooler.hpp"
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+using bench::Case;
+using bench::Sample;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+class NullBackend final : public IBackend {
+public:
+    bool print(const Job&, std::string_view) override { return true; }
+};
+
+// Splits `iterations` over `threads` threads released together; the clock
+// covers release to the last join, not thread creation.
+template <typename Fn>
+std::chrono::nanoseconds run_threads(unsigned threads, std::uint64_t iterations, Fn&& fn) {
+    std::atomic<bool> go{false};
+    std::atomic<unsigned> ready{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        const std::uint64_t share = iterations / threads + (t < iterations % threads ? 1 : 0);
+        pool.emplace_back([&, t, share] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            fn(t, share);
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    return Clock::now() - start;
+}
+
+// ---- Job state machine ----
+
+JobState next_in_retry_cycle(JobState s) {
+    switch (s) {
+        case JobState::Queued:    return JobState::Scheduled;
+        case JobState::Scheduled: return JobState::Spooling;
+        case JobState::Spooling:  return JobState::Printing;
+        default:                  return JobState::Queued;
+    }
+}
+
+// Every thread pushes one shared job around Queued -> ... -> Printing ->
+// Queued, so the CAS loop and the stale-state rejections both get exercised.
+Case transition_case(unsigned threads) {
+    return {"job.try_transition/threads:" + std::to_string(threads), threads, [threads](std::uint64_t n) {
+        Job job("bench");
+        job.enqueue();
+        Sample s;
+        s.elapsed = run_threads(threads, n, [&](unsigned, std::uint64_t share) {
+            for (std::uint64_t i = 0; i < share; ++i) {
+                bench::do_not_optimize(job.try_transition(next_in_retry_cycle(job.state())));
+            }
+        });
+        return s;
+    }};
+}
+
+// ---- Event bus ----
+
+Case publish_case(unsigned producers) {
+    return {"event_bus.publish/producers:" + std::to_string(producers), producers, [producers](std::uint64_t n) {
+        EventBus bus;
+        Sample s;
+        s.elapsed = run_threads(producers, n, [&](unsigned t, std::uint64_t share) {
+            JobEvent ev;
+            ev.job_id = t + 1;
+            ev.kind = EventKind::StateChanged;
+            ev.from = JobState::Queued;
+            ev.to = JobState::Scheduled;
+            for (std::uint64_t i = 0; i < share; ++i) {
+                ev.ts = Clock::now();
+                bus.publish(ev);
+            }
+        });
+        return s;
+    }};
+}
+
+// ---- Scheduler ----
+
+// Submit to completion of every job; jobs are created before the clock starts.
+Case scheduler_case(unsigned workers) {
+    return {"scheduler.jobs/workers:" + std::to_string(workers), workers, [workers](std::uint64_t n) {
+        Scheduler sched(workers);
+        sched.set_backend(std::make_shared<NullBackend>());
+        sched.start();
+
+        std::vector<std::shared_ptr<Job>> jobs;
+        jobs.reserve(n);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            jobs.push_back(std::make_shared<Job>("bench"));
+            jobs.back()->set_payload(std::string(64, 'x'));
+        }
+
+        Sample s;
+        const auto start = Clock::now();
+        for (auto& job : jobs) sched.submit(job);
+        for (auto& job : jobs) job->wait_terminal(60s);
+        s.elapsed = Clock::now() - start;
+        sched.stop();
+        return s;
+    }};
+}
+
+// ---- Spooler and backend ----
+
+Case spool_case() {
+    return {"text_spooler.spool", 1, [](std::uint64_t n) {
+        TextSpooler spooler;
+        Job job("bench-document");
+        Sample s;
+        const auto start = Clock::now();
+        for (std::uint64_t i = 0; i < n; ++i) {
+            auto r = spooler.spool(job);
+            s.bytes += r.buffer ? r.buffer->bytes.size() : 0;
+            bench::do_not_optimize(r);
+        }
+        s.elapsed = Clock::now() - start;
+        return s;
+    }};
+}
+
+Case file_backend_case(const std::filesystem::path& dir, std::size_t payload_size) {
+    return {"file_backend.print/bytes:" + std::to_string(payload_size), 1, [dir, payload_size](std::uint64_t n) {
+        FileBackend backend(dir);
+        Job job("bench");
+        const std::string payload(payload_size, 'x');
+        Sample s;
+        const auto start = Clock::now();
+        for (std::uint64_t i = 0; i < n; ++i) {
+            if (backend.print(job, payload)) s.bytes += payload.size();
+        }
+        s.elapsed = Clock::now() - start;
+        return s;
+    }};
+}
+
+// ---- JSON ----
+// Each document is built two ways: the nlohmann DOM PrintServer used to
+// build, and the JsonWriter it uses now.
+
+struct StatusFields {
+    std::string job_id;
+    std::string name;
+    std::string output_file;
+    const char* state;
+};
+
+std::vector<StatusFields> make_statuses(std::size_t n) {
+    std::vector<StatusFields> out;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::string name = "doc-" + std::to_string(i);
+        out.push_back({"job-" + std::to_string(100000 + i), name, "out/" + name + ".txt", "completed"});
+    }
+    return out;
+}
+
+std::string status_dom(const StatusFields& f) {
+    nlohmann::json j;
+    j["job_id"] = f.job_id;
+    j["name"] = f.name;
+    j["state"] = f.state;
+    j["output_file"] = f.output_file;
+    j["file_exists"] = true;
+    return j.dump(2);
+}
+
+void status_writer(JsonWriter& w, const StatusFields& f) {
+    w.begin_object()
+        .field("file_exists", true)
+        .field("job_id", f.job_id)
+        .field("name", f.name)
+        .field("output_file", f.output_file)
+        .field("state", f.state)
+        .end_object();
+}
+
+template <typename Render>
+Case json_case(std::string name, Render render) {
+    return {std::move(name), 1, [render](std::uint64_t n) {
+        Sample s;
+        const auto start = Clock::now();
+        for (std::uint64_t i = 0; i < n; ++i) {
+            const std::string text = render();
+            s.bytes += text.size();
+            bench::do_not_optimize(text);
+        }
+        s.elapsed = Clock::now() - start;
+        return s;
+    }};
+}
+
+std::vector<Case> json_cases() {
+    const auto one = make_statuses(1).front();
+    const auto many = std::make_shared<std::vector<StatusFields>>(make_statuses(100));
+
+    // Bus snapshot as GET /api/events serializes it
+    auto events = std::make_shared<std::vector<JobEvent>>();
+    for (std::size_t i = 0; i < 1000; ++i) {
+        JobEvent ev;
+        ev.job_id = static_cast<JobId>(i / 5);
+        ev.kind = EventKind::StateChanged;
+        ev.from = static_cast<JobState>(i % 5);
+        ev.to = static_cast<JobState>(i % 5 + 1);
+        ev.ts = Clock::now();
+        ev.dwell = std::chrono::microseconds(i);
+        events->push_back(ev);
+    }
+    const auto us = [](auto d) { return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(d).count()); };
+
+    return {
+        json_case("json.job_status/dom", [one] { return status_dom(one); }),
+        json_case("json.job_status/writer", [one] {
+            std::string out;
+            JsonWriter w(out);
+            status_writer(w, one);
+            return out;
+        }),
+        // The DOM path rendered each status, parsed it back and re-dumped the array
+        json_case("json.job_list/jobs:100/dom", [many] {
+            nlohmann::json j = nlohmann::json::array();
+            for (const auto& f : *many) j.push_back(nlohmann::json::parse(status_dom(f)));
+            return j.dump(2);
+        }),
+        json_case("json.job_list/jobs:100/writer", [many] {
+            std::string out;
+            out.reserve(many->size() * 160);
+            JsonWriter w(out);
+            w.begin_array();
+            for (const auto& f : *many) status_writer(w, f);
+            w.end_array();
+            return out;
+        }),
+        json_case("json.events/events:1000/dom", [events, us] {
+            nlohmann::json j = nlohmann::json::array();
+            for (const auto& ev : *events) {
+                nlohmann::json e;
+                e["kind"] = "state_changed";
+                e["job_name"] = "doc-" + std::to_string(ev.job_id);
+                e["from"] = job_state_to_string(ev.from);
+                e["to"] = job_state_to_string(ev.to);
+                e["reason"] = reason_to_string(ev.reason);
+                e["ts_us"] = us(ev.ts.time_since_epoch());
+                e["dwell_us"] = us(ev.dwell);
+                j.push_back(e);
+            }
+            return j.dump(2);
+        }),
+        json_case("json.events/events:1000/writer", [events, us] {
+            std::string out;
+            out.reserve(events->size() * 180);
+            JsonWriter w(out);
+            w.begin_array();
+            for (const auto& ev : *events) {
+                w.begin_object()
+                    .field("dwell_us", us(ev.dwell))
+                    .field("from", job_state_to_string(ev.from))
+                    .field("job_name", "doc-" + std::to_string(ev.job_id))
+                    .field("kind", "state_changed")
+                    .field("reason", reason_to_string(ev.reason))
+                    .field("to", job_state_to_string(ev.to))
+                    .field("ts_us", us(ev.ts.time_since_epoch()))
+                    .end_object();
+            }
+            w.end_array();
+            return out;
+        }),
+    };
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::Options opt;
+    if (!bench::parse_options(argc, argv, opt)) return 2;
+
+    const auto out_dir = std::filesystem::temp_directory_path() / "printpipe-bench";
+    const unsigned hw = std::max(2u, std::thread::hardware_concurrency());
+
+    std::vector<Case> cases = {
+        transition_case(1),
+        transition_case(hw),
+        publish_case(1),
+        publish_case(hw),
+        scheduler_case(1),
+        scheduler_case(4),
+        spool_case(),
+        file_backend_case(out_dir, 4 * 1024),
+        file_backend_case(out_dir, 1024 * 1024),
+    };
+    for (auto& c : json_cases()) cases.push_back(std::move(c));
+
+    std::vector<bench::Result> results;
+    for (const auto& c : cases) {
+        if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+        if (!opt.json) std::cerr << "running " << c.name << "...\n";
+        results.push_back(bench::run(c, opt));
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(out_dir, ec);
+
+    std::cout << (opt.json ? bench::to_json(results) : bench::to_table(results));
+    if (!opt.baseline.empty() && !bench::compare(results, opt)) return 1;
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include <nlohmann/json.hpp>
+
+#ifndef PRINTPIPE_VERSION
+#define PRINTPIPE_VERSION "unknown"
+#endif
+
+namespace printpipe {
+namespace bench {
+
+namespace {
+
+using json = nlohmann::json;
+
+double ns_per_op(const Sample& s, std::uint64_t iterations) {
+    return static_cast<double>(s.elapsed.count()) / static_cast<double>(iterations);
+}
+
+// Grows the iteration count until one run takes about `target`: by 10x
+// while runs are too short to time reliably, then by extrapolation.
+std::uint64_t calibrate(const Case& c, std::chrono::nanoseconds target) {
+    constexpr std::uint64_t kMaxIterations = std::uint64_t{1} << 40;
+    std::uint64_t n = 1;
+    for (;;) {
+        const Sample s = c.fn(n);
+        if (s.elapsed >= target || n >= kMaxIterations) return n;
+        if (s.elapsed * 10 >= target) {
+            const double scale = static_cast<double>(target.count()) / static_cast<double>(s.elapsed.count());
+            return std::max(n + 1, static_cast<std::uint64_t>(static_cast<double>(n) * scale));
+        }
+        n *= 10;
+    }
+}
+
+} // namespace
+
+Result run(const Case& c, const Options& opt) {
+    const auto target = std::chrono::duration_cast<std::chrono::nanoseconds>(opt.min_time);
+    const std::uint64_t n = calibrate(c, target);
+
+    std::vector<double> per_op;
+    std::uint64_t bytes = 0;
+    std::chrono::nanoseconds total{0};
+    for (unsigned r = 0; r < std::max(1u, opt.repetitions); ++r) {
+        const Sample s = c.fn(n);
+        per_op.push_back(ns_per_op(s, n));
+        bytes += s.bytes;
+        total += s.elapsed;
+    }
+    std::sort(per_op.begin(), per_op.end());
+
+    Result out;
+    out.name = c.name;
+    out.threads = c.threads;
+    out.iterations = n;
+    out.ns_per_op_median = per_op[per_op.size() / 2];
+    out.ns_per_op_min = per_op.front();
+    out.ns_per_op_max = per_op.back();
+    out.ops_per_sec = out.ns_per_op_median > 0 ? 1e9 / out.ns_per_op_median : 0;
+    if (bytes && total.count() > 0) {
+        out.bytes_per_sec = static_cast<double>(bytes) * 1e9 / static_cast<double>(total.count());
+    }
+    return out;
+}
+
+std::string to_json(const std::vector<Result>& results) {
+    json doc;
+    doc["version"] = PRINTPIPE_VERSION;
+    doc["results"] = json::array();
+    for (const auto& r : results) {
+        json j;
+        j["name"] = r.name;
+        j["threads"] = r.threads;
+        j["iterations"] = r.iterations;
+        j["ns_per_op"] = {{"median", r.ns_per_op_median}, {"min", r.ns_per_op_min}, {"max", r.ns_per_op_max}};
+        j["ops_per_sec"] = r.ops_per_sec;
+        if (r.bytes_per_sec > 0) j["bytes_per_sec"] = r.bytes_per_sec;
+        doc["results"].push_back(std::move(j));
+    }
+    return doc.dump(2) + "\n";
+}
+
+std::string to_table(const std::vector<Result>& results) {
+    std::ostringstream out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-40s %12s %12s %14s %10s\n",
+                  "case", "ns/op", "min", "ops/s", "MB/s");
+    out << line;
+    for (const auto& r : results) {
+        char mbps[32] = "-";
+        if (r.bytes_per_sec > 0) std::snprintf(mbps, sizeof(mbps), "%.1f", r.bytes_per_sec / 1e6);
+        std::snprintf(line, sizeof(line), "%-40s %12.1f %12.1f %14.0f %10s\n",
+                      r.name.c_str(), r.ns_per_op_median, r.ns_per_op_min, r.ops_per_sec, mbps);
+        out << line;
+    }
+    return out.str();
+}
+
+bool compare(const std::vector<Result>& results, const Options& opt) {
+    std::ifstream in(opt.baseline);
+    if (!in) {
+        std::cerr << "Cannot read baseline " << opt.baseline << "\n";
+        return false;
+    }
+    std::map<std::string, double> base;
+    try {
+        const json doc = json::parse(in);
+        for (const auto& j : doc.at("results")) {
+            base[j.at("name").get<std::string>()] = j.at("ns_per_op").at("median").get<double>();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Bad baseline " << opt.baseline << ": " << e.what() << "\n";
+        return false;
+    }
+
+    bool ok = true;
+    for (const auto& r : results) {
+        auto it = base.find(r.name);
+        if (it == base.end() || it->second <= 0) continue;
+        const double change = r.ns_per_op_median / it->second - 1.0;
+        const bool regressed = change > opt.threshold;
+        std::fprintf(stderr, "%-40s %+7.1f%%%s\n", r.name.c_str(), change * 100.0,
+                     regressed ? "  REGRESSION" : "");
+        ok = ok && !regressed;
+    }
+    return ok;
+}
+
+bool parse_options(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        try {
+            if (arg == "--filter" && has_value) {
+                opt.filter = argv[++i];
+            } else if (arg == "--min-time-ms" && has_value) {
+                opt.min_time = std::chrono::milliseconds(std::stoul(argv[++i]));
+            } else if (arg == "--repetitions" && has_value) {
+                opt.repetitions = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--json") {
+                opt.json = true;
+            } else if (arg == "--baseline" && has_value) {
+                opt.baseline = argv[++i];
+            } else if (arg == "--threshold" && has_value) {
+                opt.threshold = std::stod(argv[++i]) / 100.0;
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter TEXT] [--min-time-ms N] [--repetitions N] [--json]"
+                         " [--baseline FILE [--threshold PERCENT]]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace bench
+} // namespace printpipe
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace printpipe {
+namespace bench {
+
+// Minimal benchmark harness for printpipe_bench. Each case runs a given
+// number of operations and reports how long they took; the harness picks
+// the iteration count, repeats the run and summarizes the samples.
+
+struct Sample {
+    std::chrono::nanoseconds elapsed{0};
+    std::uint64_t bytes = 0;        // payload bytes processed, if meaningful
+};
+
+// Runs `iterations` operations and returns the time spent on them. Cases
+// time themselves so setup (creating jobs, starting threads) stays out.
+using CaseFn = std::function<Sample(std::uint64_t iterations)>;
+
+struct Case {
+    std::string name;
+    unsigned threads = 1;
+    CaseFn fn;
+};
+
+struct Options {
+    std::string filter;                             // substring of the case name
+    std::chrono::milliseconds min_time{200};        // per repetition
+    unsigned repetitions = 5;
+    bool json = false;
+    std::string baseline;                           // JSON from an earlier run
+    double threshold = 0.10;                        // allowed slowdown vs baseline
+};
+
+struct Result {
+    std::string name;
+    unsigned threads = 1;
+    std::uint64_t iterations = 0;                   // per repetition
+    double ns_per_op_median = 0;
+    double ns_per_op_min = 0;
+    double ns_per_op_max = 0;
+    double ops_per_sec = 0;                         // from the median
+    double bytes_per_sec = 0;                       // 0 when the case has no bytes
+};
+
+Result run(const Case& c, const Options& opt);
+
+std::string to_json(const std::vector<Result>& results);
+std::string to_table(const std::vector<Result>& results);
+
+// Prints how each result moved against the baseline file. Returns false if
+// any case got slower by more than opt.threshold or the file is unreadable.
+bool compare(const std::vector<Result>& results, const Options& opt);
+
+// Parses the command line; returns false (after printing usage) on errors.
+bool parse_options(int argc, char* argv[], Options& opt);
+
+// Keeps the compiler from discarding a computed value.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+} // namespace printpipe
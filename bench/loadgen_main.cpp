@@ -0,0 +1,339 @@
+// printpipe_loadgen: HTTP load generator for a local printpipe_http_server.
+//
+//   printpipe_loadgen --mode closed --connections 16 --duration-s 30
+//   printpipe_loadgen --mode open --rate 2000 --connections 64 --mix create=1,submit=1,status=6,list=1
+//
+// Closed loop: each connection sends its next request as soon as the last
+// one returns. Open loop: requests are due on a fixed schedule and latency
+// is measured from when each request was due, not when it was sent. A
+// stalled server therefore shows up in the tail instead of silently
+// lowering the offered load (no coordinated omission).
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+
+#include "latency_histogram.hpp"
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+using printpipe::bench::LatencyHistogram;
+
+namespace {
+
+enum class Op : std::size_t { Create, Submit, Status, List };
+constexpr std::size_t kOps = 4;
+constexpr std::array<const char*, kOps> kOpNames = {"create", "submit", "status", "list"};
+
+enum class Mode { Closed, Open };
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    Mode mode = Mode::Closed;
+    double rate = 1000;                         // open loop: requests/s across all connections
+    unsigned connections = 8;
+    std::chrono::seconds duration{10};
+    std::array<unsigned, kOps> mix = {1, 1, 4, 1};
+    std::size_t payload_bytes = 256;
+    bool json = false;
+    std::uint64_t seed = 1;
+};
+
+// Job ids seen so far: created ones waiting for a submit, and a bounded
+// sample of all ids for status lookups.
+class JobPool {
+public:
+    void add(std::string id) {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (known_.size() < kKnown) {
+            known_.push_back(id);
+        } else {
+            known_[next_++ % kKnown] = id;
+        }
+        unsubmitted_.push_back(std::move(id));
+    }
+
+    std::optional<std::string> take_unsubmitted() {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (unsubmitted_.empty()) return std::nullopt;
+        std::string id = std::move(unsubmitted_.front());
+        unsubmitted_.pop_front();
+        return id;
+    }
+
+    template <typename Rng>
+    std::optional<std::string> any(Rng& rng) {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (known_.empty()) return std::nullopt;
+        return known_[std::uniform_int_distribution<std::size_t>(0, known_.size() - 1)(rng)];
+    }
+
+private:
+    static constexpr std::size_t kKnown = 4096;
+
+    std::mutex mu_;
+    std::deque<std::string> unsubmitted_;
+    std::vector<std::string> known_;
+    std::size_t next_ = 0;
+};
+
+struct EndpointStats {
+    LatencyHistogram latency;
+    std::uint64_t errors = 0;
+};
+
+struct WorkerStats {
+    std::array<EndpointStats, kOps> ops;
+    std::int64_t max_lag_ns = 0;    // open loop: how late the latest send was
+};
+
+class Worker {
+public:
+    Worker(const Options& opt, JobPool& pool, unsigned index)
+        : opt_(opt), pool_(pool), index_(index), client_(opt.host, opt.port),
+          rng_(opt.seed * 7919 + index), pick_(opt.mix.begin(), opt.mix.end()),
+          payload_(opt.payload_bytes, 'x') {
+        client_.set_keep_alive(true);
+        client_.set_connection_timeout(5);
+        client_.set_read_timeout(30);
+    }
+
+    void run_closed(Clock::time_point end) {
+        while (Clock::now() < end) {
+            const auto start = Clock::now();
+            const auto [op, ok] = perform(static_cast<Op>(pick_(rng_)));
+            record(op, ok, Clock::now() - start);
+        }
+    }
+
+    void run_open(Clock::time_point t0, Clock::time_point end, std::atomic<std::uint64_t>& ticket) {
+        const double interval_ns = 1e9 / opt_.rate;
+        for (;;) {
+            const std::uint64_t i = ticket.fetch_add(1, std::memory_order_relaxed);
+            const auto due = t0 + std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(i) * interval_ns));
+            if (due >= end) return;
+            std::this_thread::sleep_until(due);
+            const auto sent = Clock::now();
+            stats_.max_lag_ns = std::max<std::int64_t>(stats_.max_lag_ns, (sent - due).count());
+            const auto [op, ok] = perform(static_cast<Op>(pick_(rng_)));
+            record(op, ok, Clock::now() - due);
+        }
+    }
+
+    const WorkerStats& stats() const { return stats_; }
+
+private:
+    struct Outcome {
+        Op op;
+        bool ok;
+    };
+
+    // Submits and status lookups need a job; without one they create it.
+    Outcome perform(Op op) {
+        if (op == Op::Submit) {
+            if (auto id = pool_.take_unsubmitted()) return {op, ok(client_.Post("/api/jobs/" + *id + "/submit"))};
+            op = Op::Create;
+        } else if (op == Op::Status) {
+            if (auto id = pool_.any(rng_)) return {op, ok(client_.Get("/api/jobs/" + *id))};
+            op = Op::Create;
+        }
+        if (op == Op::List) return {op, ok(client_.Get("/api/jobs"))};
+
+        json body;
+        body["name"] = "loadgen-" + std::to_string(index_) + "-" + std::to_string(created_++);
+        body["payload"] = payload_;
+        auto res = client_.Post("/api/jobs", body.dump(), "application/json");
+        if (!ok(res)) return {op, false};
+        try {
+            pool_.add(json::parse(res->body).at("job_id").get<std::string>());
+        } catch (...) {
+            return {op, false};
+        }
+        return {op, true};
+    }
+
+    static bool ok(const httplib::Result& res) { return res && res->status >= 200 && res->status < 300; }
+
+    void record(Op op, bool success, Clock::duration latency) {
+        auto& ep = stats_.ops[static_cast<std::size_t>(op)];
+        ep.latency.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+        if (!success) ++ep.errors;
+    }
+
+    const Options& opt_;
+    JobPool& pool_;
+    unsigned index_;
+    httplib::Client client_;
+    std::mt19937_64 rng_;
+    std::discrete_distribution<std::size_t> pick_;
+    std::string payload_;
+    std::uint64_t created_ = 0;
+    WorkerStats stats_;
+};
+
+bool parse_mix(const std::string& text, std::array<unsigned, kOps>& mix) {
+    std::array<unsigned, kOps> out{};
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const auto eq = item.find('=');
+        if (eq == std::string::npos) return false;
+        const std::string name = item.substr(0, eq);
+        std::size_t i = 0;
+        while (i < kOps && name != kOpNames[i]) ++i;
+        if (i == kOps) return false;
+        out[i] = static_cast<unsigned>(std::stoul(item.substr(eq + 1)));
+    }
+    if (out == std::array<unsigned, kOps>{}) return false;
+    mix = out;
+    return true;
+}
+
+bool parse_options(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        try {
+            if (arg == "--host" && has_value) {
+                opt.host = argv[++i];
+            } else if (arg == "--port" && has_value) {
+                opt.port = std::stoi(argv[++i]);
+            } else if (arg == "--mode" && has_value) {
+                const std::string m = argv[++i];
+                if (m != "open" && m != "closed") throw std::invalid_argument(m);
+                opt.mode = m == "open" ? Mode::Open : Mode::Closed;
+            } else if (arg == "--rate" && has_value) {
+                opt.rate = std::stod(argv[++i]);
+                if (opt.rate <= 0) throw std::invalid_argument("rate");
+            } else if (arg == "--connections" && has_value) {
+                opt.connections = std::max(1u, static_cast<unsigned>(std::stoul(argv[++i])));
+            } else if (arg == "--duration-s" && has_value) {
+                opt.duration = std::chrono::seconds(std::stoul(argv[++i]));
+            } else if (arg == "--mix" && has_value) {
+                if (!parse_mix(argv[++i], opt.mix)) throw std::invalid_argument("mix");
+            } else if (arg == "--payload-bytes" && has_value) {
+                opt.payload_bytes = std::stoul(argv[++i]);
+            } else if (arg == "--seed" && has_value) {
+                opt.seed = std::stoull(argv[++i]);
+            } else if (arg == "--json") {
+                opt.json = true;
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "usage: " << argv[0]
+                      << " [--host H] [--port P] [--mode closed|open] [--rate REQ_PER_S]"
+                         " [--connections N] [--duration-s N]"
+                         " [--mix create=W,submit=W,status=W,list=W] [--payload-bytes N]"
+                         " [--seed N] [--json]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+double ms(std::uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+void print_table(const Options& opt, const std::array<EndpointStats, kOps>& ops, double seconds, std::int64_t max_lag_ns) {
+    std::printf("%-8s %10s %8s %10s %10s %10s %10s %10s\n",
+                "endpoint", "requests", "errors", "req/s", "p50 ms", "p99 ms", "p99.9 ms", "max ms");
+    for (std::size_t i = 0; i < kOps; ++i) {
+        const auto& h = ops[i].latency;
+        if (h.count() == 0) continue;
+        std::printf("%-8s %10llu %8llu %10.1f %10.3f %10.3f %10.3f %10.3f\n", kOpNames[i],
+                    static_cast<unsigned long long>(h.count()), static_cast<unsigned long long>(ops[i].errors),
+                    static_cast<double>(h.count()) / seconds, ms(h.percentile(0.50)), ms(h.percentile(0.99)),
+                    ms(h.percentile(0.999)), ms(h.max()));
+    }
+    if (opt.mode == Mode::Open) {
+        // Sends running late means every connection was busy; latency still
+        // counts from the due time, but the rate was not really offered
+        std::printf("\nmax send lag %.3f ms%s\n", ms(static_cast<std::uint64_t>(max_lag_ns)),
+                    max_lag_ns > 100000000 ? " (add --connections to sustain the rate)" : "");
+    }
+}
+
+std::string to_json(const Options& opt, const std::array<EndpointStats, kOps>& ops, double seconds, std::int64_t max_lag_ns) {
+    json doc;
+    doc["mode"] = opt.mode == Mode::Open ? "open" : "closed";
+    doc["connections"] = opt.connections;
+    if (opt.mode == Mode::Open) doc["target_rate"] = opt.rate;
+    doc["duration_s"] = seconds;
+    doc["max_send_lag_ms"] = ms(static_cast<std::uint64_t>(max_lag_ns));
+    doc["endpoints"] = json::object();
+    for (std::size_t i = 0; i < kOps; ++i) {
+        const auto& h = ops[i].latency;
+        if (h.count() == 0) continue;
+        json ep;
+        ep["requests"] = h.count();
+        ep["errors"] = ops[i].errors;
+        ep["throughput"] = static_cast<double>(h.count()) / seconds;
+        ep["latency_ms"] = {{"p50", ms(h.percentile(0.50))}, {"p99", ms(h.percentile(0.99))},
+                            {"p99.9", ms(h.percentile(0.999))}, {"max", ms(h.max())}, {"mean", h.mean() / 1e6}};
+        json buckets = json::array();
+        for (const auto& [le, count] : h.buckets()) buckets.push_back({ms(le), count});
+        ep["histogram_ms"] = std::move(buckets);    // [upper edge, count]
+        doc["endpoints"][kOpNames[i]] = std::move(ep);
+    }
+    return doc.dump(2) + "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_options(argc, argv, opt)) return 2;
+
+    JobPool pool;
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (unsigned i = 0; i < opt.connections; ++i) workers.push_back(std::make_unique<Worker>(opt, pool, i));
+
+    std::atomic<std::uint64_t> ticket{0};
+    const auto t0 = Clock::now();
+    const auto end = t0 + opt.duration;
+    std::vector<std::thread> threads;
+    for (auto& w : workers) {
+        threads.emplace_back([&, w = w.get()] {
+            if (opt.mode == Mode::Open) {
+                w->run_open(t0, end, ticket);
+            } else {
+                w->run_closed(end);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::array<EndpointStats, kOps> total;
+    std::int64_t max_lag_ns = 0;
+    for (const auto& w : workers) {
+        for (std::size_t i = 0; i < kOps; ++i) {
+            total[i].latency.merge(w->stats().ops[i].latency);
+            total[i].errors += w->stats().ops[i].errors;
+        }
+        max_lag_ns = std::max(max_lag_ns, w->stats().max_lag_ns);
+    }
+
+    if (opt.json) {
+        std::cout << to_json(opt, total, seconds, max_lag_ns);
+    } else {
+        print_table(opt, total, seconds, max_lag_ns);
+    }
+    std::uint64_t errors = 0;
+    for (const auto& ep : total) errors += ep.errors;
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,212 @@
+// printpipe_sim: replays job arrivals through the scheduler on a virtual
+// clock to size worker counts and queue policies before changing them.
+//
+//   printpipe_sim --poisson 80 --jobs 100000 --print exp:10ms --workers 1,2,4
+//   curl -s localhost:8080/api/events > events.json
+//   printpipe_sim --trace events.json --print lognormal:8ms:0.5 --workers 1,2
+//
+// Traces are CSV ("seconds[,payload_bytes]" per job) or the JSON array
+// served by GET /api/events, where each job arrives when it is submitted
+// (its created -> queued transition).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "printpipe/simulator.hpp"
+
+using namespace printpipe;
+using json = nlohmann::json;
+
+namespace {
+
+struct Options {
+    std::string trace;
+    double poisson_rate = 0;
+    std::size_t jobs = 10000;
+    std::size_t payload_bytes = 0;
+    std::vector<std::size_t> workers = {1};
+    sim::Config config;
+    bool json = false;
+};
+
+// Arrivals from a GET /api/events export: a job reaches the scheduler at
+// its created -> queued event. Time spent in Created (waiting for a
+// payload upload) happens before submission and is not part of the load.
+bool load_events(std::istream& in, std::size_t payload_bytes, std::vector<sim::Arrival>& out, std::string& error) {
+    try {
+        const json events = json::parse(in);
+        std::vector<std::int64_t> queued_us;
+        for (const auto& ev : events) {
+            if (ev.value("kind", "") != "state_changed" || ev.value("from", "") != "created" ||
+                ev.value("to", "") != "queued") {
+                continue;
+            }
+            if (!ev.contains("ts_us")) {
+                error = "events have no ts_us; export them from a newer server";
+                return false;
+            }
+            queued_us.push_back(ev.at("ts_us").get<std::int64_t>());
+        }
+        if (queued_us.empty()) return true;
+        std::sort(queued_us.begin(), queued_us.end());
+        for (auto us : queued_us) {
+            out.push_back(sim::Arrival{std::chrono::microseconds(us - queued_us.front()), payload_bytes});
+        }
+        return true;
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+}
+
+bool parse_list(const std::string& text, std::vector<std::size_t>& out) {
+    out.clear();
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const auto n = std::stoul(item);
+        if (n == 0) return false;
+        out.push_back(n);
+    }
+    return !out.empty();
+}
+
+bool parse_options(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        try {
+            const auto distribution = [&]() {
+                auto d = sim::Distribution::parse(argv[++i]);
+                if (!d) throw std::invalid_argument(argv[i]);
+                return *d;
+            };
+            if (arg == "--trace" && has_value) {
+                opt.trace = argv[++i];
+            } else if (arg == "--poisson" && has_value) {
+                opt.poisson_rate = std::stod(argv[++i]);
+            } else if (arg == "--jobs" && has_value) {
+                opt.jobs = std::stoul(argv[++i]);
+            } else if (arg == "--payload-bytes" && has_value) {
+                opt.payload_bytes = std::stoul(argv[++i]);
+            } else if (arg == "--workers" && has_value) {
+                if (!parse_list(argv[++i], opt.workers)) throw std::invalid_argument("workers");
+            } else if (arg == "--spool" && has_value) {
+                opt.config.spool = distribution();
+            } else if (arg == "--print" && has_value) {
+                opt.config.print = distribution();
+            } else if (arg == "--print-setup" && has_value) {
+                opt.config.print_setup = distribution();
+            } else if (arg == "--failure-rate" && has_value) {
+                opt.config.failure_rate = std::stod(argv[++i]);
+            } else if (arg == "--max-attempts" && has_value) {
+                opt.config.retry.max_attempts = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--backoff-ms" && has_value) {
+                opt.config.retry.initial_backoff = std::chrono::milliseconds(std::stol(argv[++i]));
+            } else if (arg == "--coalesce") {
+                opt.config.coalescing.enabled = true;
+            } else if (arg == "--batch-jobs" && has_value) {
+                opt.config.coalescing.max_batch_jobs = std::stoul(argv[++i]);
+            } else if (arg == "--batch-bytes" && has_value) {
+                opt.config.coalescing.max_batch_bytes = std::stoul(argv[++i]);
+            } else if (arg == "--seed" && has_value) {
+                opt.config.seed = std::stoull(argv[++i]);
+            } else if (arg == "--json") {
+                opt.json = true;
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "usage: " << argv[0]
+                      << " (--trace FILE.csv|FILE.json | --poisson JOBS_PER_S [--jobs N])\n"
+                         "  [--payload-bytes N] [--workers N[,N...]] [--spool DIST] [--print DIST]\n"
+                         "  [--print-setup DIST] [--failure-rate P] [--max-attempts N] [--backoff-ms N]\n"
+                         "  [--coalesce [--batch-jobs N] [--batch-bytes N]] [--seed N] [--json]\n"
+                         "DIST: const:5ms | exp:10ms | uniform:5ms:15ms | lognormal:10ms:0.5\n";
+            return false;
+        }
+    }
+    if (opt.trace.empty() == (opt.poisson_rate <= 0)) {
+        std::cerr << "Give exactly one of --trace or --poisson\n";
+        return false;
+    }
+    return true;
+}
+
+double ms(std::chrono::nanoseconds d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+json percentiles_json(const sim::Percentiles& p) {
+    return {{"mean", ms(p.mean)}, {"p50", ms(p.p50)}, {"p99", ms(p.p99)}, {"max", ms(p.max)}};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_options(argc, argv, opt)) return 2;
+
+    std::vector<sim::Arrival> arrivals;
+    if (!opt.trace.empty()) {
+        std::ifstream in(opt.trace);
+        std::string error;
+        const bool is_json = opt.trace.size() >= 5 && opt.trace.compare(opt.trace.size() - 5, 5, ".json") == 0;
+        const bool ok = in && (is_json ? load_events(in, opt.payload_bytes, arrivals, error)
+                                       : sim::load_csv(in, arrivals, error));
+        if (!ok) {
+            std::cerr << "Cannot load " << opt.trace << (error.empty() ? "" : ": " + error) << "\n";
+            return 1;
+        }
+    } else {
+        arrivals = sim::poisson_arrivals(opt.poisson_rate, opt.jobs, opt.payload_bytes, opt.config.seed);
+    }
+
+    json runs = json::array();
+    if (!opt.json) {
+        std::printf("%7s %8s %8s %10s %6s %10s %10s %10s %10s %10s %7s %8s\n",
+                    "workers", "jobs", "failed", "jobs/s", "util", "wait mean", "wait p99", "wait max",
+                    "total p50", "total p99", "max q", "speedup");
+    }
+    for (const std::size_t workers : opt.workers) {
+        sim::Config config = opt.config;
+        config.workers = workers;
+
+        const auto wall_start = std::chrono::steady_clock::now();
+        const sim::Report r = sim::simulate(config, arrivals);
+        const auto wall = std::chrono::steady_clock::now() - wall_start;
+        const double speedup = std::chrono::duration<double>(r.makespan).count() /
+                               std::max(1e-9, std::chrono::duration<double>(wall).count());
+
+        if (opt.json) {
+            runs.push_back({{"workers", workers},
+                            {"jobs", r.jobs},
+                            {"completed", r.completed},
+                            {"failed", r.failed},
+                            {"attempts", r.attempts},
+                            {"batches", r.batches},
+                            {"makespan_s", std::chrono::duration<double>(r.makespan).count()},
+                            {"throughput", r.throughput},
+                            {"utilization", r.utilization},
+                            {"max_queue_depth", r.max_queue_depth},
+                            {"queue_delay_ms", percentiles_json(r.queue_delay)},
+                            {"sojourn_ms", percentiles_json(r.sojourn)},
+                            {"speedup", speedup}});
+        } else {
+            std::printf("%7zu %8zu %8zu %10.1f %5.0f%% %10.2f %10.2f %10.2f %10.2f %10.2f %7zu %7.0fx\n",
+                        workers, r.jobs, r.failed, r.throughput, r.utilization * 100, ms(r.queue_delay.mean),
+                        ms(r.queue_delay.p99), ms(r.queue_delay.max), ms(r.sojourn.p50), ms(r.sojourn.p99),
+                        r.max_queue_depth, speedup);
+        }
+    }
+    if (opt.json) std::cout << runs.dump(2) << "\n";
+    return 0;
+}
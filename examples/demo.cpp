@@ -70,15 +70,23 @@ job->set_payload("Hello from PrintPipe!\nThis is backend writing to a file.\n");
 
     sched.stop();
 
+    const auto stats = sched.stats();
+    if (stats.cancel_releases != 0) {
+        std::cout << "Cancel-to-release latency: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(stats.cancel_release_max).count()
+                  << " us\n";
+    }
+
     std::cout << "Final job state: " << to_string(job->state()) << "\n\n";
 
     auto evs = bus->snapshot();
     std::cout << "--- Events (" << evs.size() << ") ---\n";
     for (const auto& ev : evs) {
         std::cout << to_string(ev.kind)
-                  << " job=" << ev.job_name
+                  << " job=" << bus->job_name(ev.job_id)
                   << " " << to_string(ev.from) << " -> " << to_string(ev.to);
-        if (!ev.reason.empty()) std::cout << " reason=" << ev.reason;
+        if (ev.reason != printpipe::ReasonCode::None)
+            std::cout << " reason=" << printpipe::reason_to_string(ev.reason);
         std::cout << "\n";
     }
 
@@ -1,17 +1,34 @@
 #pragma once
 
+#include <span>
 #include <string_view>
 
 namespace printpipe {
 
 class Job;
 
+// One document of a batched backend operation.
+struct PrintItem {
+    const Job* job;
+    std::string_view payload;
+    bool ok = false;    // set by the backend
+};
+
 class IBackend {
 public:
     virtual ~IBackend() = default;
 
     // "Print" the already-spooled payload of the job.
+    // Long-running backends should check job.cancel_token() between chunks,
+    // remove any partial output and return false once it is triggered.
     virtual bool print(const Job& job, std::string_view payload) = 0;
+
+    // Print several small documents as one operation, recording the outcome
+    // of each in item.ok. Backends that can amortize per-document cost
+    // (connections, syscalls) override this; the default prints one by one.
+    virtual void print_batch(std::span<PrintItem> items) {
+        for (auto& item : items) item.ok = print(*item.job, item.payload);
+    }
 };
 
 } // namespace printpipe
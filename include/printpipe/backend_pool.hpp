@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "printpipe/backend.hpp"
+
+namespace printpipe {
+
+struct BackendPoolOptions {
+    // Default concurrent prints allowed per backend.
+    std::size_t max_in_flight = 1;
+    // Consecutive failures after which a backend is taken out of rotation,
+    // and for how long. Once the period ends the backend is half-open: a
+    // single probe print decides whether it rejoins or is ejected again.
+    std::uint32_t failure_threshold = 3;
+    std::chrono::milliseconds ejection_period{5000};
+};
+
+struct BackendStats {
+    std::size_t in_flight = 0;
+    std::size_t max_in_flight = 0;
+    std::uint64_t printed = 0;
+    std::uint64_t failed = 0;
+    bool healthy = true;
+};
+
+// Spreads prints over several backends (printers, output targets). Each
+// print goes to the less loaded of two randomly chosen healthy backends
+// with a free slot; when every slot is busy the caller waits for one.
+// A failed print is reported as-is; retries are the scheduler's job.
+// A backend that keeps failing is ejected for a while, then let back in
+// through one probe print at a time until a print succeeds.
+class BackendPool final : public IBackend {
+public:
+    explicit BackendPool(BackendPoolOptions opts = {});
+
+    // Not thread-safe against print(); add all backends up front.
+    // max_in_flight == 0 uses the pool default.
+    void add(std::shared_ptr<IBackend> backend, std::size_t max_in_flight = 0);
+
+    bool print(const Job& job, std::string_view payload) override;
+
+    // The whole batch goes to one backend and occupies a single slot.
+    void print_batch(std::span<PrintItem> items) override;
+
+    std::size_t size() const noexcept { return members_.size(); }
+    std::vector<BackendStats> stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Member {
+        std::shared_ptr<IBackend> backend;
+        std::size_t max_in_flight;
+        std::atomic<std::size_t> in_flight{0};
+        std::atomic<std::uint32_t> consecutive_failures{0};
+        std::atomic<Clock::rep> ejected_until{0};
+        std::atomic<bool> probing{false};     // half-open probe in flight
+        std::atomic<std::uint64_t> printed{0};
+        std::atomic<std::uint64_t> failed{0};
+    };
+
+    bool healthy(const Member& m, Clock::rep now) const noexcept;
+    bool half_open(const Member& m, Clock::rep now) const noexcept;
+    bool try_acquire(Member& m, Clock::rep now, bool& probe) noexcept;
+    Member* pick(bool& probe);
+    Member* acquire(const Job& job, bool& probe);
+    void release(Member& m, bool ok, bool probe);
+
+    BackendPoolOptions opts_;
+    std::vector<std::unique_ptr<Member>> members_;
+    std::atomic<std::uint64_t> seed_{0x9e3779b97f4a7c15ull};
+
+    std::mutex wait_mu_;
+    std::condition_variable_any slot_freed_;
+};
+
+} // namespace printpipe
@@ -1,32 +1,151 @@
 #pragma once
 
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "printpipe/events.hpp"
+#include "printpipe/name_table.hpp"
 
 namespace printpipe {
 
 class EventBus {
 public:
-    void publish(JobEvent ev) {
-        std::lock_guard<std::mutex> lk(mu_);
-        events_.push_back(std::move(ev));
+    using Listener = std::function<void(const JobEvent&)>;
+
+    // Events for jobs that were already retired (a late, rejected cancel,
+    // say) still reach listeners but are not logged.
+    void publish(const JobEvent& ev) {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            if (!is_retired(ev.job_id)) {
+                events_.push_back(ev);
+                ++live_[ev.job_id];
+            }
+        }
+        // Listeners run outside the lock, on the publishing thread.
+        for (const auto& l : listeners_) l(ev);
     }
 
     std::vector<JobEvent> snapshot() const {
         std::lock_guard<std::mutex> lk(mu_);
-        return events_;
+        std::vector<JobEvent> out;
+        out.reserve(events_.size());
+        for (const auto& ev : events_) {
+            if (!retired_.contains(ev.job_id)) out.push_back(ev);
+        }
+        return out;
     }
 
     void clear() {
         std::lock_guard<std::mutex> lk(mu_);
         events_.clear();
+        for (JobId id : retired_) names_.erase(id);
+        live_.clear();
+        retired_.clear();
+        retired_events_ = 0;
+    }
+
+    // Listeners must be registered before any job publishes on this bus.
+    void subscribe(Listener l) { listeners_.push_back(std::move(l)); }
+
+    // Forget a job: its events disappear from snapshots immediately. They
+    // are reclaimed as they reach the front of the log, or by a compaction
+    // pass once retired events make up half of it, so a long-lived job near
+    // the front cannot pin everything behind it.
+    void retire(JobId id) {
+        std::lock_guard<std::mutex> lk(mu_);
+        mark_retired(id);
+        auto it = live_.find(id);
+        if (it == live_.end()) {
+            names_.erase(id);
+            return;
+        }
+        if (retired_.insert(id).second) retired_events_ += it->second;
+        while (!events_.empty() && retired_.contains(events_.front().job_id)) {
+            JobId front = events_.front().job_id;
+            events_.pop_front();
+            --retired_events_;
+            auto lit = live_.find(front);
+            if (--lit->second == 0) {
+                live_.erase(lit);
+                retired_.erase(front);
+                names_.erase(front);
+            }
+        }
+        if (retired_events_ >= kCompactMin && retired_events_ * 2 >= events_.size()) compact();
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lk(mu_);
+        return events_.size();
     }
 
+    // Name resolution for serialization; never touched on the publish path.
+    void register_job(JobId id, std::string_view name) { names_.bind(id, name); }
+    std::string job_name(JobId id) const { return names_.lookup(id); }
+
 private:
+    // Fewer retired events than this are left for the front to reclaim.
+    static constexpr std::size_t kCompactMin = 1024;
+
+    void compact() {
+        std::erase_if(events_, [this](const JobEvent& ev) { return retired_.contains(ev.job_id); });
+        for (JobId id : retired_) {
+            live_.erase(id);
+            names_.erase(id);
+        }
+        retired_.clear();
+        retired_events_ = 0;
+    }
+
+    // Retired ids as merged [first, last] ranges. Ids are handed out in
+    // order and retired roughly in order, so this stays about as small as
+    // the number of jobs still alive between them.
+    void mark_retired(JobId id) {
+        auto next = retired_ranges_.upper_bound(id);
+        if (next != retired_ranges_.begin()) {
+            auto prev = std::prev(next);
+            if (id <= prev->second) return;
+            if (prev->second + 1 == id) {
+                prev->second = id;
+                if (next != retired_ranges_.end() && next->first == id + 1) {
+                    prev->second = next->second;
+                    retired_ranges_.erase(next);
+                }
+                return;
+            }
+        }
+        if (next != retired_ranges_.end() && next->first == id + 1) {
+            const JobId last = next->second;
+            retired_ranges_.erase(next);
+            retired_ranges_.emplace(id, last);
+            return;
+        }
+        retired_ranges_.emplace(id, id);
+    }
+
+    bool is_retired(JobId id) const {
+        auto it = retired_ranges_.upper_bound(id);
+        if (it == retired_ranges_.begin()) return false;
+        return id <= std::prev(it)->second;
+    }
+
     mutable std::mutex mu_;
-    std::vector<JobEvent> events_;
+    std::deque<JobEvent> events_;
+    std::unordered_map<JobId, std::uint32_t> live_;   // events held per job
+    std::unordered_set<JobId> retired_;               // retired, events still held
+    std::size_t retired_events_ = 0;                  // events held for retired_ jobs
+    std::map<JobId, JobId> retired_ranges_;           // every retired id
+    std::vector<Listener> listeners_;
+    NameTable names_;
 };
 
 } // namespace printpipe
@@ -1,24 +1,45 @@
 #pragma once
 
 #include <chrono>
-#include <string>
+#include <cstdint>
+#include <type_traits>
 
 #include "printpipe/job.hpp"
 
 namespace printpipe {
 
-enum class EventKind {
+enum class EventKind : std::uint8_t {
     StateChanged,
     RejectedTransition
 };
 
+enum class ReasonCode : std::uint8_t {
+    None,
+    TransitionNotAllowed
+};
+
+inline const char* reason_to_string(ReasonCode r) noexcept {
+    switch (r) {
+        case ReasonCode::None:                 return "";
+        case ReasonCode::TransitionNotAllowed: return "Transition not allowed by FSM";
+    }
+    return "";
+}
+
+// Plain-old-data event record. The job name is not stored here; it is
+// resolved through EventBus::job_name() when the event is serialized.
 struct JobEvent {
+    JobId job_id{};
     EventKind kind{};
-    std::string job_name;
     JobState from{};
     JobState to{};
+    ReasonCode reason{};
     std::chrono::steady_clock::time_point ts{};
-    std::string reason;
+    // Time spent in `from` before this transition (zero when rejected).
+    std::chrono::nanoseconds dwell{};
 };
 
+static_assert(std::is_trivially_copyable_v<JobEvent>,
+              "JobEvent must stay memcpy-able");
+
 } // namespace printpipe
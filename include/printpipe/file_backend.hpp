@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <string_view>
 
@@ -12,8 +13,13 @@ public:
     explicit FileBackend(std::filesystem::path out_dir = "out");
 
     bool print(const Job& job, std::string_view payload) override;
+    void print_batch(std::span<PrintItem> items) override;
 
 private:
+    bool write_file(const Job& job, std::string_view payload);
+
+    static constexpr std::size_t kChunkSize = 256 * 1024;
+
     std::filesystem::path out_dir_;
 };
 
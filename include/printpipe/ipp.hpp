@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "printpipe/job.hpp"
+#include "printpipe/payload.hpp"
+
+namespace printpipe {
+
+class JobRegistry;
+class Scheduler;
+
+// The subset of IPP/1.1 (RFC 8010/8011) needed to accept jobs from standard
+// clients: message framing, attribute encoding, and the four operations
+// IppPrinter implements.
+namespace ipp {
+
+enum class Operation : std::uint16_t {
+    PrintJob = 0x0002,
+    ValidateJob = 0x0004,
+    CancelJob = 0x0008,
+    GetJobAttributes = 0x0009
+};
+
+enum class StatusCode : std::uint16_t {
+    SuccessfulOk = 0x0000,
+    ClientErrorBadRequest = 0x0400,
+    ClientErrorNotPossible = 0x0404,
+    ClientErrorNotFound = 0x0406,
+    ServerErrorInternalError = 0x0500,
+    ServerErrorOperationNotSupported = 0x0501,
+    ServerErrorVersionNotSupported = 0x0503
+};
+
+namespace tag {
+// Delimiters (group tags)
+inline constexpr std::uint8_t OperationAttributes = 0x01;
+inline constexpr std::uint8_t JobAttributes = 0x02;
+inline constexpr std::uint8_t EndOfAttributes = 0x03;
+inline constexpr std::uint8_t PrinterAttributes = 0x04;
+inline constexpr std::uint8_t UnsupportedAttributes = 0x05;
+// Value tags
+inline constexpr std::uint8_t Integer = 0x21;
+inline constexpr std::uint8_t Boolean = 0x22;
+inline constexpr std::uint8_t Enum = 0x23;
+inline constexpr std::uint8_t OctetString = 0x30;
+inline constexpr std::uint8_t TextWithoutLanguage = 0x41;
+inline constexpr std::uint8_t NameWithoutLanguage = 0x42;
+inline constexpr std::uint8_t Keyword = 0x44;
+inline constexpr std::uint8_t Uri = 0x45;
+inline constexpr std::uint8_t Charset = 0x47;
+inline constexpr std::uint8_t NaturalLanguage = 0x48;
+inline constexpr std::uint8_t MimeMediaType = 0x49;
+} // namespace tag
+
+// One attribute value. Names and values point into the parsed buffer;
+// additional values of a multi-valued attribute repeat the name.
+struct Attribute {
+    std::uint8_t group = 0;
+    std::uint8_t value_tag = 0;
+    std::string_view name;
+    std::string_view value;
+
+    // Integer/enum value, if the value is 4 bytes wide.
+    std::optional<std::int32_t> integer() const noexcept;
+};
+
+// Request or response header plus attributes. `code` is the operation-id
+// in a request and the status-code in a response.
+struct Message {
+    std::uint8_t version_major = 1;
+    std::uint8_t version_minor = 1;
+    std::uint16_t code = 0;
+    std::uint32_t request_id = 0;
+    std::vector<Attribute> attributes;
+
+    const Attribute* find(std::uint8_t group, std::string_view name) const noexcept;
+};
+
+enum class ParseStatus {
+    Complete,
+    NeedMore,       // end-of-attributes-tag not seen yet
+    Malformed
+};
+
+// Parses the header and attribute groups at the start of `data` without
+// copying. On Complete, `header_len` is the offset of the document data.
+ParseStatus parse_message(std::string_view data, Message& out, std::size_t& header_len);
+
+// Encodes a message; groups and attributes are appended in call order.
+class MessageWriter {
+public:
+    MessageWriter(std::uint16_t code, std::uint32_t request_id);
+
+    void begin_group(std::uint8_t group_tag);
+    void add(std::uint8_t value_tag, std::string_view name, std::string_view value);
+    void add_integer(std::uint8_t value_tag, std::string_view name, std::int32_t value);
+
+    // Appends the end-of-attributes-tag and returns the encoded bytes.
+    std::string finish();
+
+private:
+    std::string out_;
+};
+
+// RFC 8011 job-state enum values.
+std::int32_t job_state(JobState s) noexcept;
+
+} // namespace ipp
+
+// Maps IPP operations onto the job registry and scheduler. The IPP job-id
+// is Job::id(); jobs are addressed by printer-uri + job-id or by job-uri.
+class IppPrinter {
+public:
+    IppPrinter(JobRegistry& registry, Scheduler& scheduler, std::string printer_uri);
+
+    const std::string& printer_uri() const noexcept { return printer_uri_; }
+
+    // One request, fed as its body arrives. Attribute bytes are buffered
+    // only until the end-of-attributes-tag; Print-Job document data goes
+    // straight into payload storage.
+    class Exchange {
+    public:
+        explicit Exchange(IppPrinter& printer);
+
+        Exchange(const Exchange&) = delete;
+        Exchange& operator=(const Exchange&) = delete;
+
+        // Returns false once the request is known to be malformed.
+        bool write(const char* data, std::size_t len);
+
+        // The request body ended early (client disconnect, short body).
+        // Drops the partial document; finish() then reports an error
+        // without running the operation.
+        void abort();
+
+        // Runs the operation and returns the encoded response.
+        std::string finish();
+
+    private:
+        bool write_document(const char* data, std::size_t len);
+
+        IppPrinter& printer_;
+        std::string header_;
+        ipp::Message request_;
+        bool parsed_ = false;
+        bool malformed_ = false;
+        bool aborted_ = false;
+        std::optional<PayloadWriter> writer_;
+        std::string document_;      // used when the registry has no payload store
+    };
+
+    // Largest attribute section accepted before the document data.
+    static constexpr std::size_t kMaxHeaderBytes = 64 * 1024;
+
+private:
+    std::string print_job(const ipp::Message& req, PayloadPtr document);
+    std::string cancel_job(const ipp::Message& req);
+    std::string get_job_attributes(const ipp::Message& req);
+    std::shared_ptr<Job> target_job(const ipp::Message& req) const;
+    std::string job_uri(JobId id) const;
+    void add_job_attributes(ipp::MessageWriter& w, const Job& job) const;
+
+    JobRegistry& registry_;
+    Scheduler& scheduler_;
+    std::string printer_uri_;
+};
+
+} // namespace printpipe
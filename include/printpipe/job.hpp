@@ -1,15 +1,26 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <mutex>
+#include <optional>
 #include <string_view>
+#include <stop_token>
+
+#include "printpipe/payload.hpp"
+#include "printpipe/retry_policy.hpp"
+
 namespace printpipe {
 
 class EventBus;
 
+// Compact process-wide job identifier, used in events instead of the name.
+using JobId = std::uint32_t;
+
 enum class JobState : std::uint8_t {
     Created,
     Queued,
@@ -31,6 +42,7 @@ class Job {
 public:
     explicit Job(std::string name);
 
+    JobId id() const noexcept;
     const std::string& name() const noexcept;
     JobState state() const noexcept;
 
@@ -38,7 +50,13 @@ public:
 
    // Spool payload API (thread-safe)
    void set_payload(std::string data);
+   void set_payload(PayloadPtr payload);
+   // Replaces the payload only while the job is still Created; false once
+   // it has been submitted (the check and the swap are atomic together).
+   bool set_payload_if_created(PayloadPtr payload);
+   PayloadPtr payload() const;
    std::string payload_copy() const;
+   std::size_t payload_size() const;
 
 
     bool enqueue() noexcept;
@@ -48,23 +66,66 @@ public:
     bool complete() noexcept;
     bool fail() noexcept;
     bool cancel() noexcept;
+    bool requeue() noexcept;    // Printing -> Queued, for a retry
+
+    // Print attempts so far; bumped by the scheduler before each attempt.
+    std::uint32_t attempts() const noexcept { return attempts_.load(std::memory_order_relaxed); }
+    std::uint32_t begin_attempt() noexcept { return attempts_.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    // Overrides the scheduler's retry policy; set before submitting.
+    void set_retry_policy(RetryPolicy p) { retry_policy_ = p; }
+    const std::optional<RetryPolicy>& retry_policy() const noexcept { return retry_policy_; }
 
     static bool is_terminal(JobState s) noexcept;
 
-    void set_event_bus(std::shared_ptr<EventBus> bus) { bus_ = std::move(bus); }
-    
+    // Block until the job reaches a terminal state or the timeout expires.
+    // Returns the state observed last.
+    JobState wait_terminal(std::chrono::steady_clock::duration timeout) const;
+
+    // Cooperative cancellation. Spoolers and backends poll the token between
+    // chunks of work and bail out once cancel() has been called.
+    std::stop_token cancel_token() const noexcept { return cancel_source_.get_token(); }
+    bool cancel_requested() const noexcept { return cancel_source_.stop_requested(); }
+    std::chrono::steady_clock::time_point cancel_requested_at() const noexcept;
+
+    // When the job entered its current state.
+    std::chrono::steady_clock::time_point state_entered_at() const noexcept {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(entered_at_.load(std::memory_order_relaxed)));
+    }
+
+    void set_event_bus(std::shared_ptr<EventBus> bus);
 
 private:
     static bool is_valid_transition(JobState from, JobState to) noexcept;
 
+    JobId id_;
     std::string name_;
     std::atomic<JobState> state_{JobState::Created};
     std::shared_ptr<EventBus> bus_;
+    // When the current state was entered; feeds JobEvent::dwell.
+    std::atomic<std::chrono::steady_clock::rep> entered_at_;
+
+    std::atomic<std::uint32_t> attempts_{0};
+    std::optional<RetryPolicy> retry_policy_;
+
+    mutable std::mutex wait_mu_;
+    mutable std::condition_variable terminal_cv_;
+
+    std::stop_source cancel_source_;
+    std::atomic<std::chrono::steady_clock::rep> canceled_at_{0};
 
    mutable std::mutex payload_mu_;
-   std::string payload_;
+   PayloadPtr payload_;
+   // Set by set_payload_if_created() around its state check and swap. A
+   // transition out of Created waits for it to clear, so no swap lands
+   // after the job has moved on (and try_transition() takes no lock).
+   std::atomic<bool> payload_swapping_{false};
 
 
 };
 
+// Lower-case state name, as used in the HTTP API and metrics labels.
+const char* job_state_to_string(JobState s) noexcept;
+
 } // namespace printpipe
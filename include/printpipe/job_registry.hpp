@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "printpipe/event_bus.hpp"
+#include "printpipe/job.hpp"
+#include "printpipe/payload.hpp"
+
+namespace printpipe {
+
+// Limits on how many finished jobs the registry keeps around. A zero value
+// disables that limit; the default policy retains everything.
+struct RetentionPolicy {
+    std::chrono::steady_clock::duration max_age{};
+    std::size_t max_terminal_jobs = 0;
+    std::size_t max_bytes = 0;
+    bool delete_output_files = false;
+};
+
+struct JobRecord {
+    std::string id;
+    std::shared_ptr<Job> job;
+    std::filesystem::path output_file;
+};
+
+// Owns every job known to a front end, keyed by its public string id.
+// Terminal jobs are tracked in completion order so retention can evict the
+// oldest ones a few at a time without scanning the whole registry.
+class JobRegistry {
+public:
+    JobRegistry(std::filesystem::path output_dir, std::shared_ptr<EventBus> bus);
+
+    JobRegistry(const JobRegistry&) = delete;
+    JobRegistry& operator=(const JobRegistry&) = delete;
+
+    JobRecord create(const std::string& name, std::string payload);
+    JobRecord create(const std::string& name, PayloadPtr payload);
+    std::optional<JobRecord> find(const std::string& id) const;
+    std::optional<JobRecord> find_by_job_id(JobId id) const;
+    std::vector<JobRecord> list() const;
+    std::size_t size() const;
+
+    // Jobs ever created here, including ones since evicted.
+    std::uint64_t created_total() const noexcept { return counter_.load(std::memory_order_relaxed); }
+
+    void set_retention_policy(RetentionPolicy policy);
+
+    // Route payloads through a store so large ones can be spilled to disk.
+    // Without one, payloads stay in memory.
+    void set_payload_store(std::shared_ptr<PayloadStore> store) { payload_store_ = std::move(store); }
+    const std::shared_ptr<PayloadStore>& payload_store() const noexcept { return payload_store_; }
+
+    // Evict up to max_evictions terminal jobs that fall outside the policy.
+    // Returns the number evicted. Cheap when nothing is due.
+    std::size_t sweep(std::size_t max_evictions = 64);
+
+    // Also sweep from a background thread every `interval`, so age limits
+    // hold while no requests arrive. Runs until the registry is destroyed.
+    void sweep_every(std::chrono::milliseconds interval);
+
+    // Approximate memory held by terminal jobs still in the registry.
+    std::size_t retained_bytes() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Finished {
+        JobId job_id;
+        Clock::time_point at;
+    };
+
+    struct Retained {
+        JobId job_id;
+        Clock::time_point at;
+        std::size_t bytes;
+    };
+
+    // Shared with the event bus listener so it stays valid even if a worker
+    // publishes after the registry is gone.
+    struct FinishedLog {
+        std::mutex mu;
+        std::vector<Finished> pending;
+    };
+
+    static std::size_t footprint(const JobRecord& rec);
+    bool over_limits(const Retained& oldest, Clock::time_point now) const;
+
+    std::filesystem::path output_dir_;
+    std::shared_ptr<EventBus> bus_;
+    std::shared_ptr<PayloadStore> payload_store_;
+    std::shared_ptr<FinishedLog> finished_;
+
+    mutable std::mutex mu_;
+    std::map<std::string, JobRecord> jobs_;
+    std::unordered_map<JobId, std::map<std::string, JobRecord>::iterator> by_job_id_;
+    std::deque<Retained> retained_;     // terminal jobs, oldest first
+    std::size_t retained_bytes_ = 0;
+    // Records per output file; jobs with the same name share one file, so
+    // it is only deleted once the last of them is evicted.
+    std::unordered_map<std::string, std::size_t> output_refs_;
+    RetentionPolicy policy_;
+    std::atomic<std::uint64_t> counter_{0};
+
+    std::mutex sweep_mu_;               // one sweeper at a time
+
+    std::mutex timer_mu_;
+    std::condition_variable_any timer_cv_;
+    std::jthread timer_;                // last: stops before the state it sweeps
+};
+
+} // namespace printpipe
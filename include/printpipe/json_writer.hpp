@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace printpipe {
+
+// Streaming JSON writer that appends straight to a caller-owned string, for
+// responses that would otherwise build a DOM just to serialize it. Compact
+// by default; pretty output matches nlohmann::json::dump(2) formatting.
+// The caller is responsible for well-formed nesting (keys only inside
+// objects, balanced begin/end); nesting deeper than 64 levels is not
+// supported. Strings are written as UTF-8 with control characters escaped;
+// invalid UTF-8 is replaced with U+FFFD, as nlohmann's
+// error_handler_t::replace does, rather than aborting the response.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out, bool pretty = false) : out_(out), pretty_(pretty) {}
+
+    JsonWriter& begin_object() { return open('{'); }
+    JsonWriter& end_object() { return close('}'); }
+    JsonWriter& begin_array() { return open('['); }
+    JsonWriter& end_array() { return close(']'); }
+
+    JsonWriter& key(std::string_view k);
+
+    JsonWriter& value(std::string_view s);
+    JsonWriter& value(const char* s) { return value(std::string_view(s)); }
+    JsonWriter& value(bool b);
+    JsonWriter& value(std::int64_t n);
+    JsonWriter& value(std::uint64_t n);
+    JsonWriter& value(int n) { return value(static_cast<std::int64_t>(n)); }
+    JsonWriter& value(unsigned n) { return value(static_cast<std::uint64_t>(n)); }
+    JsonWriter& value(double d);
+    JsonWriter& null();
+
+    template <typename T>
+    JsonWriter& field(std::string_view k, const T& v) {
+        key(k);
+        return value(v);
+    }
+
+private:
+    JsonWriter& open(char bracket);
+    JsonWriter& close(char bracket);
+    void before_value();
+    void newline_indent();
+    void write_string(std::string_view s);
+
+    std::string& out_;
+    bool pretty_;
+    unsigned depth_ = 0;
+    std::uint64_t has_items_ = 0;   // bit d: container at depth d+1 is non-empty
+    bool after_key_ = false;
+};
+
+} // namespace printpipe
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "printpipe/job.hpp"
+
+namespace printpipe {
+
+class JobRegistry;
+class Scheduler;
+
+// Binary submission protocol for co-located producers, spoken over a Unix
+// domain stream socket. All integers are little-endian.
+//
+//   request  := u32 length | u8 op | body            (length covers op + body)
+//   response := u32 length | u8 status | body
+//
+//   CreateSubmit  body: u16 name_len | name | u8 mode | payload
+//                 mode 0: payload bytes follow inline (rest of the frame)
+//                 mode 1: no inline bytes; the document is a file descriptor
+//                         sent with SCM_RIGHTS on the same message. A memfd
+//                         sealed with F_SEAL_SHRINK | F_SEAL_WRITE is mapped;
+//                         other regular files are copied; anything else is
+//                         rejected with BadRequest
+//                 reply:  u16 id_len | job id
+//   Status        body: u16 id_len | job id            reply: u8 JobState
+//   Wait          body: u32 timeout_ms | u16 id_len | job id
+//                 reply: u8 JobState (status Timeout if still running)
+namespace local_proto {
+
+enum class Op : std::uint8_t {
+    CreateSubmit = 1,
+    Status = 2,
+    Wait = 3
+};
+
+enum class Status : std::uint8_t {
+    Ok = 0,
+    NotFound = 1,
+    BadRequest = 2,
+    Error = 3,
+    Timeout = 4
+};
+
+enum class PayloadMode : std::uint8_t {
+    Inline = 0,
+    Fd = 1
+};
+
+// Largest frame accepted, for inline payloads; bigger documents go by fd.
+inline constexpr std::uint32_t kMaxFrame = 64u << 20;
+
+} // namespace local_proto
+
+// Listens on a Unix domain socket and feeds the same registry and scheduler
+// as the HTTP front end. One thread per connection; connections are meant
+// to be long-lived.
+class LocalSubmitServer {
+public:
+    LocalSubmitServer(std::filesystem::path socket_path, JobRegistry& registry, Scheduler& scheduler);
+    ~LocalSubmitServer();
+
+    LocalSubmitServer(const LocalSubmitServer&) = delete;
+    LocalSubmitServer& operator=(const LocalSubmitServer&) = delete;
+
+    // Who may connect, applied to the socket file before listening. Owner
+    // only by default, like the spool; widen (e.g. add group_write) to let
+    // other local users submit. Set before start().
+    void set_socket_permissions(std::filesystem::perms perms) { perms_ = perms; }
+
+    // Bind and start accepting. Replaces a stale socket file at the path.
+    bool start();
+    void stop();
+
+    const std::filesystem::path& socket_path() const noexcept { return path_; }
+
+private:
+    struct Connection {
+        int fd = -1;
+        bool done = false;      // set by the serving thread on exit
+        std::thread thread;
+    };
+
+    void accept_loop();
+    void serve(Connection& conn);
+
+    std::filesystem::path path_;
+    JobRegistry& registry_;
+    Scheduler& scheduler_;
+    std::filesystem::perms perms_ = std::filesystem::perms::owner_read | std::filesystem::perms::owner_write;
+
+    int listen_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread acceptor_;
+
+    std::mutex conns_mu_;
+    std::list<Connection> conns_;   // stable addresses for serving threads
+};
+
+// Minimal blocking client for the protocol above.
+class LocalSubmitClient {
+public:
+    LocalSubmitClient() = default;
+    ~LocalSubmitClient();
+
+    LocalSubmitClient(const LocalSubmitClient&) = delete;
+    LocalSubmitClient& operator=(const LocalSubmitClient&) = delete;
+
+    bool connect(const std::filesystem::path& socket_path);
+
+    // Returns the job id, or nullopt on failure.
+    std::optional<std::string> submit(std::string_view name, std::string_view payload);
+    std::optional<std::string> submit_fd(std::string_view name, int document_fd);
+
+    std::optional<JobState> status(std::string_view job_id);
+    std::optional<JobState> wait(std::string_view job_id, std::chrono::milliseconds timeout);
+
+private:
+    bool send_frame(std::string_view head, std::string_view tail, int pass_fd);
+    std::optional<std::string> read_reply(local_proto::Status& status);
+    std::optional<JobState> state_request(local_proto::Op op, std::string_view body);
+
+    int fd_ = -1;
+};
+
+} // namespace printpipe
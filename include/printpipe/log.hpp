@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace printpipe {
+namespace log {
+
+// Asynchronous logger. Callers format into a fixed-size record and push it
+// onto a bounded lock-free queue; a background thread does all the I/O.
+// When the queue is full or the rate limit is hit, records are dropped and
+// counted rather than blocking the caller.
+
+enum class Level : std::uint8_t {
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+// Longest message kept; longer ones are truncated.
+inline constexpr std::size_t kMaxMessage = 240;
+
+namespace detail {
+extern std::atomic<Level> g_level;
+} // namespace detail
+
+inline bool enabled(Level level) noexcept {
+    return level >= detail::g_level.load(std::memory_order_relaxed);
+}
+
+void set_level(Level level) noexcept;
+
+// Records per second accepted below Error; 0 disables the limit.
+void set_rate_limit(std::uint32_t per_second) noexcept;
+
+// Where the writer thread sends records (stdout by default). The stream
+// must outlive the logger or the next set_sink() call.
+void set_sink(std::FILE* sink) noexcept;
+
+// printf-style; never blocks on I/O.
+void write(Level level, const char* fmt, ...) noexcept
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+// Blocks until everything enqueued so far has been written.
+void flush();
+
+struct Stats {
+    std::uint64_t written = 0;
+    std::uint64_t dropped_full = 0;     // queue was full
+    std::uint64_t dropped_rate = 0;     // over the rate limit
+};
+Stats stats() noexcept;
+
+} // namespace log
+} // namespace printpipe
+
+// The level check comes first so disabled levels skip argument evaluation.
+#define PRINTPIPE_LOG(level, ...)                                              \
+    do {                                                                       \
+        if (::printpipe::log::enabled(level)) ::printpipe::log::write(level, __VA_ARGS__); \
+    } while (0)
+
+#define PRINTPIPE_LOG_DEBUG(...) PRINTPIPE_LOG(::printpipe::log::Level::Debug, __VA_ARGS__)
+#define PRINTPIPE_LOG_INFO(...)  PRINTPIPE_LOG(::printpipe::log::Level::Info, __VA_ARGS__)
+#define PRINTPIPE_LOG_WARN(...)  PRINTPIPE_LOG(::printpipe::log::Level::Warn, __VA_ARGS__)
+#define PRINTPIPE_LOG_ERROR(...) PRINTPIPE_LOG(::printpipe::log::Level::Error, __VA_ARGS__)
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "printpipe/events.hpp"
+
+namespace printpipe {
+
+class EventBus;
+
+// Recording is a relaxed atomic update; nothing on the hot path locks.
+
+class Counter {
+public:
+    void inc(std::uint64_t n = 1) noexcept { v_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t value() const noexcept { return v_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> v_{0};
+};
+
+class Gauge {
+public:
+    void add(std::int64_t n) noexcept { v_.fetch_add(n, std::memory_order_relaxed); }
+    void set(std::int64_t n) noexcept { v_.store(n, std::memory_order_relaxed); }
+    std::int64_t value() const noexcept { return v_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> v_{0};
+};
+
+// Fixed-bucket histogram; bucket bounds are upper limits in ascending order.
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double v) noexcept;
+    void observe(std::chrono::nanoseconds d) noexcept {
+        observe(std::chrono::duration<double>(d).count());
+    }
+
+    struct Snapshot {
+        std::vector<double> bounds;
+        std::vector<std::uint64_t> cumulative;  // per bound, then +Inf
+        double sum = 0;
+    };
+    Snapshot snapshot() const;
+
+    // 100us .. ~26s in powers of two; suits stage and request latencies.
+    static std::vector<double> latency_buckets();
+
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts_;   // bounds_.size() + 1
+    std::atomic<double> sum_{0};
+};
+
+// Owns metric series and renders them in the Prometheus text format.
+// Registration and rendering lock; the returned references stay valid for
+// the registry's lifetime and are updated without it.
+class MetricsRegistry {
+public:
+    enum class Type { Counter, Gauge, Histogram };
+
+    // `labels` is the preformatted label set, e.g. `state="queued"`.
+    // Asking again for the same name and labels returns the same series.
+    Counter& counter(std::string_view name, std::string_view help, std::string labels = {});
+    Gauge& gauge(std::string_view name, std::string_view help, std::string labels = {});
+    Histogram& histogram(std::string_view name, std::string_view help, std::string labels = {},
+                         std::vector<double> bounds = Histogram::latency_buckets());
+
+    // A counter or gauge whose value lives elsewhere, read at scrape time.
+    void sampled(std::string_view name, std::string_view help, Type type, std::string labels,
+                 std::function<double()> read);
+
+    std::string render() const;
+
+private:
+    struct Series {
+        std::string labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> read;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<Series> series;
+    };
+
+    Series& series(std::string_view name, std::string_view help, Type type, std::string labels);
+
+    mutable std::mutex mu_;
+    std::vector<Family> families_;
+};
+
+// Job counts by state and per-stage latency histograms, derived from the
+// event stream (JobEvent::dwell is the time spent in the stage just left).
+class JobMetrics {
+public:
+    // `created_total` reports how many jobs have been created; no event is
+    // published for that, so it comes from the job's owner. Attach before
+    // jobs start publishing on the bus.
+    static std::shared_ptr<JobMetrics> attach(std::shared_ptr<MetricsRegistry> metrics, EventBus& bus,
+                                              std::function<std::uint64_t()> created_total);
+
+    explicit JobMetrics(std::shared_ptr<MetricsRegistry> metrics);
+
+    void on_event(const JobEvent& ev) noexcept;
+
+    // Jobs currently in `s`; terminal states count every job that got there.
+    std::int64_t in_state(JobState s, std::uint64_t created_total) const noexcept;
+
+private:
+    static constexpr std::size_t kStates = 8;
+
+    std::shared_ptr<MetricsRegistry> metrics_;
+    std::array<std::atomic<std::uint64_t>, kStates> entered_{};
+    std::array<std::atomic<std::uint64_t>, kStates> left_{};
+    std::array<Histogram*, kStates> stage_{};
+};
+
+} // namespace printpipe
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "printpipe/job.hpp"
+
+namespace printpipe {
+
+// Maps job ids to their names. Identical names share one interned string,
+// so many jobs called "invoice" cost a single allocation.
+class NameTable {
+public:
+    void bind(JobId id, std::string_view name) {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto it = strings_.try_emplace(std::string(name), 0).first;
+        ++it->second;
+        auto& slot = by_id_[id];
+        if (slot) release_locked(slot);
+        slot = &it->first;
+    }
+
+    void erase(JobId id) {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto it = by_id_.find(id);
+        if (it == by_id_.end()) return;
+        release_locked(it->second);
+        by_id_.erase(it);
+    }
+
+    std::string lookup(JobId id) const {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto it = by_id_.find(id);
+        if (it == by_id_.end()) return {};
+        return *it->second;
+    }
+
+private:
+    void release_locked(const std::string* name) {
+        auto it = strings_.find(*name);
+        if (it != strings_.end() && --it->second == 0) strings_.erase(it);
+    }
+
+    mutable std::mutex mu_;
+    std::unordered_map<std::string, std::uint32_t> strings_;   // name -> users
+    std::unordered_map<JobId, const std::string*> by_id_;
+};
+
+} // namespace printpipe
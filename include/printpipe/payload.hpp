@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace printpipe {
+
+// Read access to a payload. Spilled payloads are mapped for the lifetime of
+// the view and unmapped when it goes away.
+class PayloadView {
+public:
+    PayloadView() = default;
+    ~PayloadView();
+
+    PayloadView(PayloadView&& other) noexcept;
+    PayloadView& operator=(PayloadView&& other) noexcept;
+    PayloadView(const PayloadView&) = delete;
+    PayloadView& operator=(const PayloadView&) = delete;
+
+    std::string_view data() const noexcept { return data_; }
+    bool valid() const noexcept { return valid_; }
+
+private:
+    friend class Payload;
+
+    std::string_view data_;
+    void* map_ = nullptr;
+    std::size_t map_len_ = 0;
+    bool valid_ = false;
+};
+
+// Immutable job document, held either in memory or in a spool file that is
+// removed when the last reference goes away.
+class Payload {
+public:
+    ~Payload();
+
+    Payload(const Payload&) = delete;
+    Payload& operator=(const Payload&) = delete;
+
+    // Untracked in-memory payload (tests, demo, direct Job users).
+    static std::shared_ptr<const Payload> from_string(std::string data);
+
+    // Map a document handed over as a file descriptor without copying it.
+    // Only memfds sealed against shrinking and writing qualify: anything
+    // else could be truncated under the mapping (SIGBUS) or rewritten after
+    // submission. The descriptor is not consumed. Returns nullptr if the
+    // descriptor does not qualify or cannot be mapped.
+    static std::shared_ptr<const Payload> from_fd(int fd);
+
+    // Whether from_fd() would accept the descriptor.
+    static bool sealed_fd(int fd);
+
+    std::size_t size() const noexcept { return size_; }
+    bool spilled() const noexcept { return !file_.empty(); }
+    bool mapped() const noexcept { return map_ != nullptr; }
+    std::size_t resident_bytes() const noexcept { return spilled() || mapped() ? 0 : data_.size(); }
+
+    PayloadView view() const;
+
+private:
+    friend class PayloadStore;
+    friend class PayloadWriter;
+
+    Payload() = default;
+
+    std::string data_;
+    std::filesystem::path file_;
+    void* map_ = nullptr;       // from_fd(): mapped for the payload's lifetime
+    std::size_t size_ = 0;
+    std::shared_ptr<std::atomic<std::size_t>> resident_;   // store accounting
+};
+
+using PayloadPtr = std::shared_ptr<const Payload>;
+
+struct PayloadStoreConfig {
+    // Payloads at or above this size go straight to the spool directory.
+    std::size_t spill_threshold = 1u << 20;
+    // Cap on bytes kept in memory across all payloads from this store;
+    // anything that would exceed it is spilled regardless of size.
+    std::size_t max_resident_bytes = 256u << 20;
+    // Created 0700 when missing. An existing directory must be owned by this
+    // user; spool files inside it are created exclusively, mode 0600.
+    std::filesystem::path spool_dir = std::filesystem::temp_directory_path() / "printpipe-spool";
+};
+
+class PayloadStore;
+
+// Builds a payload from streamed chunks. Data is buffered in memory until it
+// reaches the store's spill threshold, then everything goes to a spool file,
+// so each byte is held at most once.
+class PayloadWriter {
+public:
+    explicit PayloadWriter(PayloadStore& store);
+    ~PayloadWriter();
+
+    PayloadWriter(const PayloadWriter&) = delete;
+    PayloadWriter& operator=(const PayloadWriter&) = delete;
+
+    // Returns false once the spool file cannot be written.
+    bool append(const char* data, std::size_t len);
+
+    // Returns nullptr if any write failed.
+    PayloadPtr finish();
+
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    bool spill_buffer();
+
+    PayloadStore* store_;
+    std::string buf_;
+    std::filesystem::path file_;
+    int fd_ = -1;
+    std::size_t size_ = 0;
+    bool failed_ = false;
+};
+
+class PayloadStore {
+public:
+    explicit PayloadStore(PayloadStoreConfig cfg = {});
+
+    PayloadStore(const PayloadStore&) = delete;
+    PayloadStore& operator=(const PayloadStore&) = delete;
+
+    // Throws std::runtime_error if a payload has to be spilled and the
+    // spool file cannot be written.
+    PayloadPtr store(std::string data);
+
+    // Stream a payload in chunks; the store must outlive the writer.
+    PayloadWriter writer() { return PayloadWriter(*this); }
+
+    std::size_t resident_bytes() const noexcept { return resident_->load(std::memory_order_relaxed); }
+    const PayloadStoreConfig& config() const noexcept { return cfg_; }
+
+private:
+    friend class PayloadWriter;
+
+    bool try_reserve(std::size_t n) noexcept;
+    std::filesystem::path next_spool_path();
+    bool ensure_spool_dir() const;
+    // Opens a new spool file for writing and sets `path`; -1 on failure.
+    int create_spool_file(std::filesystem::path& path);
+
+    PayloadStoreConfig cfg_;
+    std::shared_ptr<std::atomic<std::size_t>> resident_;
+    std::atomic<std::uint64_t> seq_{0};
+};
+
+} // namespace printpipe
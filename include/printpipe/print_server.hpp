@@ -1,22 +1,67 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <mutex>
-#include <map>
-#include <atomic>
+#include <vector>
 #include <filesystem>
 
+#include "printpipe/backend.hpp"
 #include "printpipe/job.hpp"
+#include "printpipe/job_registry.hpp"
 #include "printpipe/spooler.hpp"
 #include "printpipe/scheduler.hpp"
 #include "printpipe/event_bus.hpp"
+#include "printpipe/ipp.hpp"
+#include "printpipe/local_submit.hpp"
+#include "printpipe/metrics.hpp"
+
+namespace httplib {
+class Server;
+} // namespace httplib
 
 namespace printpipe {
 
+class JsonWriter;
+class StaticAssets;
+
+// How the HTTP front end accepts and serves connections. Defaults match
+// cpp-httplib's own.
+struct HttpFrontendConfig {
+    std::string host = "0.0.0.0";
+
+    // Sockets bound to the same port with SO_REUSEPORT, each with its own
+    // accept thread and worker pool; the kernel spreads connections across
+    // them. Falls back to one where SO_REUSEPORT is unavailable.
+    std::size_t listeners = 1;
+
+    // Worker threads per listener; 0 keeps httplib's default
+    // (max(8, cores - 1)). A keep-alive connection occupies a worker for
+    // its whole lifetime, so size this for concurrent clients.
+    std::size_t worker_threads = 0;
+    // Requests waiting for a worker before new ones are rejected; 0 = unbounded.
+    std::size_t max_queued_requests = 0;
+
+    std::size_t keep_alive_max_count = 5;           // requests per connection
+    std::chrono::seconds keep_alive_timeout{5};     // idle time before closing
+    std::chrono::seconds read_timeout{5};
+    std::chrono::seconds write_timeout{5};
+};
+
+// Where printed jobs go. Several backends are spread over with a
+// BackendPool, one print in flight per device, so throughput scales with
+// the devices attached; with none, jobs are written to the output directory.
+struct PrintDeviceConfig {
+    std::vector<std::shared_ptr<IBackend>> backends;
+    // Scheduler worker threads; 0 = one per backend (at least one).
+    std::size_t workers = 0;
+};
+
 class PrintServer {
 public:
-    PrintServer(int port = 8080, std::filesystem::path output_dir = "out");
+    PrintServer(int port = 8080, std::filesystem::path output_dir = "out", HttpFrontendConfig http = {},
+                PrintDeviceConfig devices = {});
     ~PrintServer();
 
     // Start the HTTP server (blocking)
@@ -28,29 +73,42 @@ public:
     // Set the spooler implementation
     void set_spooler(SpoolerPtr spooler);
 
+    // Set where job payloads live (in memory or spilled to disk)
+    void set_payload_store(std::shared_ptr<PayloadStore> store);
+
+    // Limit how many finished jobs (and their events) are kept
+    void set_retention_policy(RetentionPolicy policy);
+
+    // Also accept jobs over a Unix domain socket (see local_submit.hpp).
+    // Starts listening immediately; returns false if the socket can't be bound.
+    bool enable_local_socket(std::filesystem::path socket_path);
+
     // Get event bus for monitoring
     std::shared_ptr<EventBus> event_bus() const { return event_bus_; }
 
-private:
-    struct JobEntry {
-        std::shared_ptr<Job> job;
-        std::filesystem::path output_file;
-    };
+    // Metrics served at /metrics; callers may register their own series
+    std::shared_ptr<MetricsRegistry> metrics() const { return metrics_; }
 
+private:
     int port_;
     std::filesystem::path output_dir_;
+    HttpFrontendConfig http_;
     std::shared_ptr<EventBus> event_bus_;
+    std::shared_ptr<MetricsRegistry> metrics_;
+    std::shared_ptr<JobMetrics> job_metrics_;
     std::shared_ptr<Scheduler> scheduler_;
-    
-    std::mutex jobs_mutex_;
-    std::map<std::string, JobEntry> jobs_;
-    std::atomic<uint64_t> job_counter_{0};
+    JobRegistry registry_;
+    std::unique_ptr<LocalSubmitServer> local_server_;
+    std::unique_ptr<IppPrinter> ipp_printer_;
+    std::unique_ptr<StaticAssets> assets_;     // web/ directory, served from memory
 
     // Helper methods
-    std::string create_job(const std::string& name, const std::string& payload);
+    void register_metrics();
+    void register_routes(httplib::Server& server);
+    void configure_listener(httplib::Server& server) const;
+    std::string create_job(const std::string& name, std::string payload);
     bool submit_job(const std::string& job_id);
-    std::string get_job_status(const std::string& job_id);
-    std::vector<std::string> list_jobs();
+    static void write_job_status(JsonWriter& w, const JobRecord& rec);
     std::string get_output_file(const std::string& job_id);
 };
 
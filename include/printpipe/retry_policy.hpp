@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace printpipe {
+
+// Exponential backoff with jitter for jobs whose backend print fails.
+// The default (a single attempt) keeps the old fail-fast behavior.
+struct RetryPolicy {
+    std::uint32_t max_attempts = 1;
+    std::chrono::milliseconds initial_backoff{200};
+    std::chrono::milliseconds max_backoff{30'000};
+    double multiplier = 2.0;
+    double jitter = 0.2;    // +/- fraction of the computed delay
+
+    // Delay before attempt `attempt + 1`, given that `attempt` (>= 1) failed.
+    // `unit_random` is a uniform sample in [0, 1).
+    std::chrono::milliseconds backoff(std::uint32_t attempt, double unit_random) const {
+        double delay = static_cast<double>(initial_backoff.count());
+        for (std::uint32_t i = 1; i < attempt && delay < max_backoff.count(); ++i) delay *= multiplier;
+        delay = std::min(delay, static_cast<double>(max_backoff.count()));
+        delay *= 1.0 - jitter + 2.0 * jitter * unit_random;
+        return std::chrono::milliseconds(static_cast<std::int64_t>(std::max(delay, 0.0)));
+    }
+};
+
+} // namespace printpipe
@@ -1,22 +1,61 @@
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <random>
 #include <thread>
 #include <atomic>
+#include <vector>
 
 #include "printpipe/job.hpp"
 #include "printpipe/spooler.hpp"
 #include "printpipe/backend.hpp"
+#include "printpipe/retry_policy.hpp"
+#include "printpipe/timer_wheel.hpp"
 
 
 namespace printpipe {
 
+struct SchedulerStats {
+    // Canceled jobs dropped by the worker, and how long after cancel() each
+    // was released (covers in-flight spool/print work being abandoned).
+    std::uint64_t cancel_releases = 0;
+    std::chrono::nanoseconds cancel_release_total{0};
+    std::chrono::nanoseconds cancel_release_max{0};
+
+    std::uint64_t retries_scheduled = 0;
+    std::size_t retries_pending = 0;
+
+    std::uint64_t batches = 0;          // coalesced backend operations
+    std::uint64_t batched_jobs = 0;     // jobs printed as part of one
+
+    std::size_t queued = 0;             // jobs waiting for a worker
+    std::uint64_t spooled_bytes = 0;
+    std::uint64_t printed_bytes = 0;    // payload bytes the backend accepted
+};
+
+// Groups consecutive small jobs into one IBackend::print_batch() call.
+// Off by default; each job still goes through its own state transitions.
+struct CoalescingPolicy {
+    bool enabled = false;
+    std::size_t max_job_bytes = 16 * 1024;      // larger jobs print alone
+    std::size_t max_batch_bytes = 256 * 1024;
+    std::size_t max_batch_jobs = 64;
+    // How long a worker holding a small job waits for more to join it.
+    std::chrono::microseconds window{0};
+};
+
 class Scheduler {
 public:
-    Scheduler();
+    // `workers` threads run jobs concurrently; use one per print device
+    // (or per backend pool slot) so throughput scales with devices.
+    explicit Scheduler(std::size_t workers = 1);
     ~Scheduler();
 
     Scheduler(const Scheduler&) = delete;
@@ -25,24 +64,92 @@ public:
     void start();
     void stop();
 
+    std::size_t worker_count() const noexcept { return worker_count_; }
+
     bool submit(std::shared_ptr<Job> job);
 
     void set_spooler(SpoolerPtr s) { spooler_ = std::move(s); }
     void set_backend(std::shared_ptr<IBackend> b) { backend_ = std::move(b); }
 
+    // Called with each canceled job's cancel-to-release latency, on the
+    // worker that released it (e.g. to feed a histogram). Set before start().
+    using ReleaseObserver = std::function<void(std::chrono::nanoseconds)>;
+    void set_cancel_release_observer(ReleaseObserver o) { cancel_release_observer_ = std::move(o); }
+
+    // Default retry policy for jobs that don't carry their own.
+    void set_retry_policy(RetryPolicy p);
+
+    void set_coalescing(CoalescingPolicy p);
+
+    SchedulerStats stats() const;
+
+    // ---- Manual stepping ----
+    // Runs the scheduling logic on the caller's thread and clock instead of
+    // worker threads; sim::Simulator replays traffic this way. Don't mix
+    // with start(). Time points are taken relative to created_at().
+
+    // The next job, or coalesced batch, ready at `now`. Never blocks: the
+    // coalescing window is not waited out.
+    bool poll(std::chrono::steady_clock::time_point now, std::vector<std::shared_ptr<Job>>& out);
+    // Moves a polled job through the spooler to Printing and starts an
+    // attempt; false if the job dropped out (canceled or spool failure).
+    bool begin(Job& job);
+    // Applies the print outcome of the current attempt; a retry is due
+    // relative to `now`.
+    void settle(const std::shared_ptr<Job>& job, bool ok, std::chrono::steady_clock::time_point now);
+    // Earliest time a pending retry may become ready.
+    std::optional<std::chrono::steady_clock::time_point> next_retry_due() const;
+
+    // Makes retry jitter reproducible.
+    void set_jitter_seed(std::uint32_t seed);
+
+    // Origin of the retry timer wheel; retries due at the same offset from
+    // it fire on the same tick.
+    std::chrono::steady_clock::time_point created_at() const noexcept { return created_at_; }
+
 private:
     void worker_loop();
+    bool next_jobs(std::vector<std::shared_ptr<Job>>& out);
+    bool coalesce_queued(std::vector<std::shared_ptr<Job>>& out, std::size_t& bytes, const CoalescingPolicy& policy);
+    bool prepare(Job& job);
+    void finish(const std::shared_ptr<Job>& job, std::uint32_t attempt, bool ok,
+                std::chrono::steady_clock::time_point now);
+    void run_one(const std::shared_ptr<Job>& job);
+    void run_batch(const std::vector<std::shared_ptr<Job>>& jobs);
+    void release_canceled(const Job& job);
+    bool schedule_retry(const std::shared_ptr<Job>& job, std::uint32_t attempt,
+                        std::chrono::steady_clock::time_point now);
+
+    static constexpr std::chrono::milliseconds kRetryTick{10};
 
-    std::mutex mu_;
+    mutable std::mutex mu_;
     std::condition_variable cv_;
     std::deque<std::shared_ptr<Job>> q_;
 
-    std::thread worker_;
+    const std::chrono::steady_clock::time_point created_at_ = std::chrono::steady_clock::now();
+    // Jobs waiting out a retry backoff; guarded by mu_.
+    TimerWheel<std::shared_ptr<Job>> retries_{kRetryTick, created_at_};
+    RetryPolicy retry_policy_;
+    std::minstd_rand jitter_rng_{std::random_device{}()};
+    std::uint64_t retries_scheduled_ = 0;
+    CoalescingPolicy coalescing_;
+
+    std::size_t worker_count_;
+    std::vector<std::thread> workers_;
     std::atomic<bool> running_{false};
     std::atomic<bool> stop_requested_{false};
 
     SpoolerPtr spooler_;
     std::shared_ptr<IBackend> backend_;
+    ReleaseObserver cancel_release_observer_;
+
+    std::atomic<std::uint64_t> cancel_releases_{0};
+    std::atomic<std::int64_t> cancel_release_total_ns_{0};
+    std::atomic<std::int64_t> cancel_release_max_ns_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    std::atomic<std::uint64_t> batched_jobs_{0};
+    std::atomic<std::uint64_t> spooled_bytes_{0};
+    std::atomic<std::uint64_t> printed_bytes_{0};
 
 };
 
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "printpipe/backend.hpp"
+#include "printpipe/retry_policy.hpp"
+#include "printpipe/scheduler.hpp"
+#include "printpipe/spooler.hpp"
+
+namespace printpipe {
+namespace sim {
+
+// Discrete-event simulation of the scheduler for capacity planning. The
+// real Scheduler and Job state machine run on a virtual clock through
+// Scheduler's manual stepping API; spooling and printing take synthetic
+// service times, so hours of traffic replay in seconds. Runs with the same
+// inputs and seed produce identical reports.
+
+// Service-time distribution.
+class Distribution {
+public:
+    static Distribution constant(std::chrono::nanoseconds value);
+    static Distribution exponential(std::chrono::nanoseconds mean);
+    static Distribution uniform(std::chrono::nanoseconds lo, std::chrono::nanoseconds hi);
+    static Distribution lognormal(std::chrono::nanoseconds median, double sigma);
+
+    // "const:5ms", "exp:20ms", "uniform:5ms:15ms" or "lognormal:20ms:0.5";
+    // units are ns, us, ms and s.
+    static std::optional<Distribution> parse(std::string_view spec);
+
+    std::chrono::nanoseconds sample(std::mt19937_64& rng) const;
+    std::chrono::nanoseconds mean() const;
+
+private:
+    enum class Kind : std::uint8_t { Constant, Exponential, Uniform, LogNormal };
+
+    Kind kind_ = Kind::Constant;
+    double a_ = 0;      // ns: value, mean, lo or median
+    double b_ = 0;      // ns for uniform's hi, sigma for lognormal
+};
+
+// Spooler whose work is a sampled duration, added up for the simulator.
+class SyntheticSpooler final : public ISpooler {
+public:
+    SyntheticSpooler(Distribution service, std::uint64_t seed);
+
+    SpoolResult spool(const Job& job) override;
+
+    // Service time accumulated since the last call.
+    std::chrono::nanoseconds take_elapsed();
+
+private:
+    Distribution service_;
+    std::mt19937_64 rng_;
+    std::chrono::nanoseconds elapsed_{0};
+};
+
+// Backend with a sampled per-operation setup cost plus a per-document
+// print time, failing each document with a fixed probability. A batch pays
+// the setup once, as a pooled connection would.
+class SyntheticBackend final : public IBackend {
+public:
+    SyntheticBackend(Distribution setup, Distribution per_document, double failure_rate, std::uint64_t seed);
+
+    bool print(const Job& job, std::string_view payload) override;
+    void print_batch(std::span<PrintItem> items) override;
+
+    std::chrono::nanoseconds take_elapsed();
+
+private:
+    Distribution setup_;
+    Distribution per_document_;
+    double failure_rate_;
+    std::mt19937_64 rng_;
+    std::chrono::nanoseconds elapsed_{0};
+};
+
+// One job reaching the scheduler, relative to the start of the trace.
+struct Arrival {
+    std::chrono::nanoseconds at{0};
+    std::size_t payload_bytes = 0;
+};
+
+// Reads "seconds[,payload_bytes]" lines; blank lines, '#' comments and a
+// non-numeric header line are skipped. Arrivals are sorted by time. On a
+// bad line returns false and describes it in `error`.
+bool load_csv(std::istream& in, std::vector<Arrival>& out, std::string& error);
+
+// Poisson arrivals at `rate` jobs per second.
+std::vector<Arrival> poisson_arrivals(double rate, std::size_t jobs, std::size_t payload_bytes, std::uint64_t seed);
+
+struct Config {
+    std::size_t workers = 1;
+    Distribution spool = Distribution::constant(std::chrono::nanoseconds(0));
+    Distribution print_setup = Distribution::constant(std::chrono::nanoseconds(0));
+    Distribution print = Distribution::exponential(std::chrono::milliseconds(10));
+    double failure_rate = 0.0;
+    RetryPolicy retry;
+    CoalescingPolicy coalescing;
+    std::uint64_t seed = 1;
+};
+
+struct Percentiles {
+    std::chrono::nanoseconds mean{0};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds max{0};
+};
+
+struct Report {
+    std::size_t jobs = 0;
+    std::size_t completed = 0;
+    std::size_t failed = 0;
+    std::uint64_t attempts = 0;         // backend attempts, retries included
+    std::uint64_t batches = 0;          // backend operations
+
+    std::chrono::nanoseconds makespan{0};   // first arrival to last job done
+    double throughput = 0;                  // finished jobs per virtual second
+    double utilization = 0;                 // busy worker time / available
+    std::size_t max_queue_depth = 0;
+
+    Percentiles queue_delay;            // arrival to first dispatch
+    Percentiles sojourn;                // arrival to terminal state
+};
+
+Report simulate(const Config& config, std::span<const Arrival> arrivals);
+
+} // namespace sim
+} // namespace printpipe
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "printpipe/backend.hpp"
+
+namespace printpipe {
+
+struct SocketBackendOptions {
+    std::string host = "127.0.0.1";
+    std::uint16_t port = 9100;
+    // Idle connections kept open for reuse; extra ones are closed.
+    std::size_t max_idle_connections = 4;
+    std::chrono::milliseconds connect_timeout{2000};
+    // Upper bound on the time spent writing one document or batch, so a
+    // device that drains slowly cannot hold a worker indefinitely.
+    std::chrono::milliseconds write_timeout{10000};
+    // Pooled connections idle longer than this are dropped, not reused.
+    std::chrono::milliseconds idle_timeout{30000};
+    // Sent around every document (e.g. PJL job wrapper, form feed).
+    std::string preamble;
+    std::string trailer;
+};
+
+struct SocketBackendStats {
+    std::uint64_t connects = 0;
+    std::uint64_t reuses = 0;
+    std::uint64_t failures = 0;
+};
+
+// Raw TCP ("port 9100" / AppSocket) printing to a single device. Documents
+// are streamed with non-blocking scatter writes over pooled persistent
+// connections; a stale pooled connection is replaced transparently if the
+// write fails before any byte was accepted.
+class SocketBackend final : public IBackend {
+public:
+    explicit SocketBackend(SocketBackendOptions opts);
+    ~SocketBackend() override;
+
+    SocketBackend(const SocketBackend&) = delete;
+    SocketBackend& operator=(const SocketBackend&) = delete;
+
+    bool print(const Job& job, std::string_view payload) override;
+
+    // Streams every document back to back on one connection with a single
+    // scatter-write loop; documents fully accepted before a failure count
+    // as printed.
+    void print_batch(std::span<PrintItem> items) override;
+
+    SocketBackendStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Idle {
+        int fd;
+        Clock::time_point since;
+    };
+
+    enum class SendResult { Ok, Failed, FailedUntouched, Canceled };
+
+    int connect_new();
+    int acquire(bool& reused);
+    void release(int fd);
+    bool wait_writable(int fd, const std::stop_token& token, Clock::time_point deadline) const;
+    SendResult send_documents(int fd, std::span<const std::string_view> docs,
+                              const std::stop_token& token, Clock::time_point deadline,
+                              std::size_t& sent);
+    SendResult send_with_reconnect(int& fd, bool reused, std::span<const std::string_view> docs,
+                                   const std::stop_token& token, Clock::time_point deadline,
+                                   std::size_t& sent);
+
+    SocketBackendOptions opts_;
+
+    std::mutex mu_;
+    std::vector<Idle> idle_;
+
+    std::atomic<std::uint64_t> connects_{0};
+    std::atomic<std::uint64_t> reuses_{0};
+    std::atomic<std::uint64_t> failures_{0};
+};
+
+} // namespace printpipe
@@ -18,6 +18,7 @@ struct SpoolResult {
 class ISpooler {
 public:
     virtual ~ISpooler() = default;
+    // Implementations should give up early when job.cancel_requested().
     virtual SpoolResult spool(const Job& job) = 0;
 };
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace printpipe {
+
+// One file from the web root, ready to serve.
+struct StaticAsset {
+    std::string content_type;
+    std::string body;
+    std::string etag;           // strong validator, quoted: "\"<hash>\""
+    // Gzip-encoded body and its own ETag; empty when compression does not
+    // pay off (images, tiny files) or zlib is unavailable.
+    std::string gzip;
+    std::string gzip_etag;
+};
+
+using StaticAssetPtr = std::shared_ptr<const StaticAsset>;
+
+// In-memory copy of a directory of web assets (the web UI). Files are read
+// and compressed once per (re)load; lookups never touch the disk. A reload
+// builds a new table and swaps it in, so requests in flight keep the
+// version they started with.
+class StaticAssets {
+public:
+    explicit StaticAssets(std::filesystem::path root);
+    ~StaticAssets();
+
+    StaticAssets(const StaticAssets&) = delete;
+    StaticAssets& operator=(const StaticAssets&) = delete;
+
+    // Reads every regular, non-hidden file under the root. Returns how many
+    // assets are now served; a missing root leaves the table empty.
+    std::size_t reload();
+
+    // Asset for a URL path such as "/app.js"; "/" and directory paths map
+    // to their index.html. nullptr when there is no such asset.
+    StaticAssetPtr find(std::string_view url_path) const;
+
+    // Reloads automatically when files under the root change (inotify).
+    // Returns false where that is unsupported or the root can't be watched.
+    bool watch();
+
+    std::size_t size() const;
+    const std::filesystem::path& root() const noexcept { return root_; }
+
+    // Whether gzip variants are built at all (zlib was found at build time).
+    static bool gzip_supported() noexcept;
+
+    // Files above this size are skipped rather than held in memory.
+    static constexpr std::size_t kMaxFileBytes = 16u << 20;
+
+private:
+    using Table = std::unordered_map<std::string, StaticAssetPtr>;
+
+    void watch_loop();
+
+    std::filesystem::path root_;
+    mutable std::mutex mu_;
+    std::shared_ptr<const Table> table_;
+
+    int watch_fd_ = -1;         // inotify instance
+    int wake_fd_ = -1;          // eventfd that stops the watcher
+    std::thread watcher_;
+};
+
+// True if an If-None-Match header value names `etag` (or is "*").
+bool etag_matches(std::string_view if_none_match, std::string_view etag) noexcept;
+
+// True if an Accept-Encoding header value allows gzip.
+bool accepts_gzip(std::string_view accept_encoding) noexcept;
+
+} // namespace printpipe
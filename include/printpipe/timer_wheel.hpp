@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace printpipe {
+
+// Hierarchical timer wheel: four levels of 64 slots each, so with a 10 ms
+// tick it covers ~31 hours before clamping. Scheduling is O(1); advancing
+// costs O(1) per elapsed tick plus the work of moving due items, and an
+// entry is cascaded at most once per level. Not thread-safe.
+template <typename T>
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimerWheel(Clock::duration tick, Clock::time_point origin = Clock::now())
+        : tick_(tick), origin_(origin) {}
+
+    void schedule(T item, Clock::time_point due) {
+        std::uint64_t due_tick = tick_of(due);
+        if (due_tick <= now_tick_) due_tick = now_tick_ + 1;
+        insert(Entry{due_tick, std::move(item)});
+        ++size_;
+    }
+
+    // Move the wheel forward to `now`, appending every item that came due.
+    void advance(Clock::time_point now, std::vector<T>& out) {
+        const std::uint64_t target = ticks_elapsed(now);
+        if (size_ == 0) {
+            if (target > now_tick_) now_tick_ = target;
+            return;
+        }
+        while (now_tick_ < target) {
+            ++now_tick_;
+            for (std::size_t level = kLevels - 1; level > 0; --level) {
+                if ((now_tick_ & level_mask(level)) == 0) cascade(level);
+            }
+            auto& slot = wheels_[0][now_tick_ & kSlotMask];
+            for (auto& e : slot) out.push_back(std::move(e.item));
+            size_ -= slot.size();
+            slot.clear();
+            if (size_ == 0) {
+                now_tick_ = target;
+                break;
+            }
+        }
+    }
+
+    // Earliest time at which advance() may produce something; nullopt if empty.
+    std::optional<Clock::time_point> next_due() const {
+        if (size_ == 0) return std::nullopt;
+        // Higher levels cannot fire before their next cascade point
+        std::uint64_t best = (now_tick_ | kSlotMask) + 1;
+        for (std::uint64_t t = now_tick_ + 1; t < best; ++t) {
+            if (!wheels_[0][t & kSlotMask].empty()) {
+                best = t;
+                break;
+            }
+        }
+        return origin_ + tick_ * static_cast<Clock::rep>(best);
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    void clear() {
+        for (auto& level : wheels_)
+            for (auto& slot : level) slot.clear();
+        size_ = 0;
+    }
+
+private:
+    static constexpr std::size_t kSlotBits = 6;
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+    static constexpr std::size_t kLevels = 4;
+
+    struct Entry {
+        std::uint64_t due_tick;
+        T item;
+    };
+
+    static constexpr std::uint64_t level_mask(std::size_t level) {
+        return (std::uint64_t{1} << (kSlotBits * level)) - 1;
+    }
+
+    // Due times round up and the wheel position rounds down, so nothing
+    // fires early; items may fire up to one tick late.
+    std::uint64_t tick_of(Clock::time_point t) const {
+        if (t <= origin_) return 0;
+        const auto d = t - origin_;
+        return static_cast<std::uint64_t>((d + tick_ - Clock::duration(1)) / tick_);
+    }
+
+    std::uint64_t ticks_elapsed(Clock::time_point t) const {
+        if (t <= origin_) return 0;
+        return static_cast<std::uint64_t>((t - origin_) / tick_);
+    }
+
+    void insert(Entry e) {
+        const std::uint64_t delta = e.due_tick > now_tick_ ? e.due_tick - now_tick_ : 0;
+        std::size_t level = 0;
+        while (level + 1 < kLevels && delta > level_mask(level + 1)) ++level;
+        std::uint64_t at = e.due_tick;
+        if (delta > level_mask(kLevels)) {
+            // Beyond the horizon: park in the farthest slot and re-cascade
+            at = now_tick_ + level_mask(kLevels);
+        }
+        wheels_[level][(at >> (kSlotBits * level)) & kSlotMask].push_back(std::move(e));
+    }
+
+    void cascade(std::size_t level) {
+        auto& slot = wheels_[level][(now_tick_ >> (kSlotBits * level)) & kSlotMask];
+        std::vector<Entry> moving;
+        moving.swap(slot);
+        for (auto& e : moving) insert(std::move(e));
+    }
+
+    Clock::duration tick_;
+    Clock::time_point origin_;
+    std::uint64_t now_tick_ = 0;
+    std::size_t size_ = 0;
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> wheels_;
+};
+
+} // namespace printpipe
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "printpipe/job.hpp"
+
+namespace printpipe {
+namespace trace {
+
+// Span recording into per-thread ring buffers, exported as Chrome
+// trace-event JSON (loads in chrome://tracing and Perfetto). Disabled by
+// default; a disabled span costs one relaxed load.
+
+// Spans kept per thread; older ones are overwritten.
+inline constexpr std::size_t kRingCapacity = 4096;
+
+struct Span {
+    const char* name = nullptr;     // static lifetime: a literal or intern()ed
+    JobId job = 0;                  // 0 for spans not tied to a job
+    std::uint32_t tid = 0;          // ring id, stable per thread
+    std::int64_t start_ns = 0;      // steady_clock
+    std::int64_t dur_ns = 0;
+};
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+} // namespace detail
+
+inline bool enabled() noexcept { return detail::g_enabled.load(std::memory_order_relaxed); }
+void set_enabled(bool on) noexcept;
+
+inline std::int64_t now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Appends to the calling thread's ring, overwriting its oldest span.
+void record(const char* name, JobId job, std::int64_t start_ns, std::int64_t end_ns) noexcept;
+
+// Copies a name into storage that lives for the rest of the process, for
+// span names built at runtime (e.g. route patterns). Not for hot paths.
+const char* intern(std::string_view name);
+
+// Records the enclosing scope as one span.
+class Scope {
+public:
+    explicit Scope(const char* name, JobId job = 0) noexcept
+        : name_(name), job_(job), start_(enabled() ? now_ns() : 0) {}
+    ~Scope() {
+        if (start_) record(name_, job_, start_, now_ns());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    void set_job(JobId job) noexcept { job_ = job; }
+
+private:
+    const char* name_;
+    JobId job_;
+    std::int64_t start_;
+};
+
+// Spans currently held by all rings, oldest first; optionally one job's.
+std::vector<Span> collect(std::optional<JobId> job = std::nullopt);
+
+std::string to_chrome_json(const std::vector<Span>& spans);
+
+// Writes collect() as Chrome JSON to `out` whenever `signo` arrives.
+// Returns false if the handler could not be installed.
+bool dump_on_signal(int signo, std::filesystem::path out);
+
+} // namespace trace
+} // namespace printpipe
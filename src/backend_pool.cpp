@@ -0,0 +1,172 @@
+#include "printpipe/backend_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "printpipe/job.hpp"
+
+namespace printpipe {
+
+BackendPool::BackendPool(BackendPoolOptions opts)
+    : opts_(opts) {}
+
+void BackendPool::add(std::shared_ptr<IBackend> backend, std::size_t max_in_flight) {
+    auto m = std::make_unique<Member>();
+    m->backend = std::move(backend);
+    m->max_in_flight = max_in_flight ? max_in_flight : opts_.max_in_flight;
+    members_.push_back(std::move(m));
+}
+
+bool BackendPool::healthy(const Member& m, Clock::rep now) const noexcept {
+    return m.ejected_until.load(std::memory_order_relaxed) <= now;
+}
+
+// Ejection has run out but no print has succeeded since: the backend only
+// takes a single probe until it proves itself.
+bool BackendPool::half_open(const Member& m, Clock::rep now) const noexcept {
+    return healthy(m, now) &&
+           m.consecutive_failures.load(std::memory_order_relaxed) >= std::max(opts_.failure_threshold, 1u);
+}
+
+bool BackendPool::try_acquire(Member& m, Clock::rep now, bool& probe) noexcept {
+    probe = false;
+    if (half_open(m, now)) {
+        bool idle = false;
+        if (!m.probing.compare_exchange_strong(idle, true, std::memory_order_acq_rel)) return false;
+        probe = true;
+    }
+
+    std::size_t cur = m.in_flight.load(std::memory_order_relaxed);
+    do {
+        if (cur >= m.max_in_flight) {
+            if (probe) m.probing.store(false, std::memory_order_release);
+            probe = false;
+            return false;
+        }
+    } while (!m.in_flight.compare_exchange_weak(cur, cur + 1, std::memory_order_acq_rel));
+    return true;
+}
+
+BackendPool::Member* BackendPool::pick(bool& probe) {
+    const std::size_t n = members_.size();
+    if (n == 0) return nullptr;
+
+    // Cheap per-call randomness (splitmix64 over a shared counter)
+    std::uint64_t x = seed_.fetch_add(0x9e3779b97f4a7c15ull, std::memory_order_relaxed);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    x ^= x >> 31;
+
+    const auto now = Clock::now().time_since_epoch().count();
+    const bool any_healthy = [&] {
+        for (const auto& m : members_) if (healthy(*m, now)) return true;
+        return false;
+    }();
+    // If everything is ejected, keep serving from the whole pool
+    auto eligible = [&](const Member& m) { return !any_healthy || healthy(m, now); };
+
+    // ---- Power of two choices ----
+    Member* a = members_[x % n].get();
+    Member* b = members_[(x >> 32) % n].get();
+    if (!eligible(*a)) a = nullptr;
+    if (!eligible(*b)) b = nullptr;
+    if (a && b && b->in_flight.load(std::memory_order_relaxed) < a->in_flight.load(std::memory_order_relaxed))
+        std::swap(a, b);
+    if (a && try_acquire(*a, now, probe)) return a;
+    if (b && b != a && try_acquire(*b, now, probe)) return b;
+
+    // ---- Both busy: take any eligible backend with a free slot ----
+    const std::size_t start = x % n;
+    for (std::size_t i = 0; i < n; ++i) {
+        Member& m = *members_[(start + i) % n];
+        if (eligible(m) && try_acquire(m, now, probe)) return &m;
+    }
+    return nullptr;
+}
+
+void BackendPool::release(Member& m, bool ok, bool probe) {
+    if (ok) {
+        m.printed.fetch_add(1, std::memory_order_relaxed);
+        m.consecutive_failures.store(0, std::memory_order_relaxed);
+    } else {
+        m.failed.fetch_add(1, std::memory_order_relaxed);
+        const auto streak = m.consecutive_failures.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (streak >= opts_.failure_threshold) {
+            const auto until = Clock::now() + opts_.ejection_period;
+            m.ejected_until.store(until.time_since_epoch().count(), std::memory_order_relaxed);
+        }
+    }
+    // The probe's outcome is recorded above; let the next one through
+    if (probe) m.probing.store(false, std::memory_order_release);
+
+    m.in_flight.fetch_sub(1, std::memory_order_acq_rel);
+    {
+        // Pairs with the predicate check in print() so a wakeup can't be lost
+        std::lock_guard<std::mutex> lk(wait_mu_);
+    }
+    slot_freed_.notify_one();
+}
+
+BackendPool::Member* BackendPool::acquire(const Job& job, bool& probe) {
+    Member* m = pick(probe);
+    if (!m && !members_.empty()) {
+        std::unique_lock<std::mutex> lk(wait_mu_);
+        // Gives up (nullptr) if the job is canceled while waiting for a device
+        slot_freed_.wait(lk, job.cancel_token(), [&] { return (m = pick(probe)) != nullptr; });
+    }
+    return m;
+}
+
+bool BackendPool::print(const Job& job, std::string_view payload) {
+    bool probe = false;
+    Member* m = acquire(job, probe);
+    if (!m) return false;
+
+    bool ok = false;
+    try {
+        ok = m->backend->print(job, payload);
+    } catch (...) {
+        ok = false;
+    }
+    // A canceled print says nothing about the device's health
+    release(*m, ok || job.cancel_requested(), probe);
+    return ok;
+}
+
+void BackendPool::print_batch(std::span<PrintItem> items) {
+    for (auto& item : items) item.ok = false;
+    if (items.empty()) return;
+
+    bool probe = false;
+    Member* m = acquire(*items.front().job, probe);
+    if (!m) return;
+
+    try {
+        m->backend->print_batch(items);
+    } catch (...) {
+        for (auto& item : items) item.ok = false;
+    }
+    // Canceled documents say nothing about the device's health
+    bool all_ok = true;
+    for (const auto& item : items) {
+        if (!item.ok && !item.job->cancel_requested()) all_ok = false;
+    }
+    release(*m, all_ok, probe);
+}
+
+std::vector<BackendStats> BackendPool::stats() const {
+    const auto now = Clock::now().time_since_epoch().count();
+    std::vector<BackendStats> out;
+    out.reserve(members_.size());
+    for (const auto& m : members_) {
+        out.push_back(BackendStats{
+            m->in_flight.load(std::memory_order_relaxed),
+            m->max_in_flight,
+            m->printed.load(std::memory_order_relaxed),
+            m->failed.load(std::memory_order_relaxed),
+            healthy(*m, now) && !half_open(*m, now)});
+    }
+    return out;
+}
+
+} // namespace printpipe
@@ -32,7 +32,10 @@ make -j$(nproc)
 
 #include "printpipe/file_backend.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <string>
+#include <system_error>
 
 #include "printpipe/job.hpp"
 
@@ -44,17 +47,61 @@ FileBackend::FileBackend(std::filesystem::path out_dir)
 bool FileBackend::print(const Job& job, std::string_view payload) {
     try {
         std::filesystem::create_directories(out_dir_);
-        auto path = out_dir_ / (job.name() + ".txt");
-
-        std::ofstream out(path, std::ios::binary);
-        if (!out) return false;
-
-        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
-        out.flush();
-        return static_cast<bool>(out);
+        return write_file(job, payload);
     } catch (...) {
         return false;
     }
 }
 
+void FileBackend::print_batch(std::span<PrintItem> items) {
+    // One directory check for the whole batch; each job still gets its own file
+    std::error_code ec;
+    std::filesystem::create_directories(out_dir_, ec);
+    for (auto& item : items) {
+        try {
+            item.ok = write_file(*item.job, item.payload);
+        } catch (...) {
+            item.ok = false;
+        }
+    }
+}
+
+bool FileBackend::write_file(const Job& job, std::string_view payload) {
+    // Jobs with the same name share an output file: write a private temp
+    // file and rename it into place, so a canceled or failed job never
+    // truncates or removes an earlier job's finished document
+    const auto path = out_dir_ / (job.name() + ".txt");
+    auto tmp = path;
+    tmp += ".part-" + std::to_string(job.id());
+
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    // Write in chunks so a cancel lands promptly on large documents
+    const auto token = job.cancel_token();
+    bool ok = true;
+    for (std::size_t off = 0; off < payload.size(); off += kChunkSize) {
+        if (token.stop_requested()) {
+            ok = false;
+            break;
+        }
+        const auto n = std::min(kChunkSize, payload.size() - off);
+        out.write(payload.data() + off, static_cast<std::streamsize>(n));
+        if (!out) {
+            ok = false;
+            break;
+        }
+    }
+    out.close();
+    ok = ok && !out.fail();
+
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(tmp, path, ec);
+        ok = !ec;
+    }
+    if (!ok) std::filesystem::remove(tmp, ec);
+    return ok;
+}
+
 } // namespace printpipe
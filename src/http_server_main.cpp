@@ -1,8 +1,15 @@
 #include <iostream>
 #include <csignal>
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
+#include "printpipe/log.hpp"
 #include "printpipe/print_server.hpp"
+#include "printpipe/socket_backend.hpp"
+#include "printpipe/trace.hpp"
 
 std::atomic<bool> running{true};
 
@@ -13,15 +20,151 @@ void signal_handler(int signal) {
     }
 }
 
+static void usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [port] [options]\n"
+              << "  --unix-socket PATH          also accept local submissions\n"
+              << "  --log-level LEVEL           debug|info|warn|error|off\n"
+              << "  --log-rate N                records/s below error (0 = unlimited)\n"
+              << "  --trace                     record spans (GET /api/trace, SIGUSR1)\n"
+              << "  --host ADDR                 bind address (default 0.0.0.0)\n"
+              << "  --listeners N               SO_REUSEPORT listeners, 1-64\n"
+              << "  --threads N                 workers per listener, 1-4096\n"
+              << "  --max-queued N              queued requests per listener (0 = unbounded)\n"
+              << "  --keep-alive-max N          requests per connection, 1-1000000\n"
+              << "  --keep-alive-timeout S      idle seconds, 1-3600\n"
+              << "  --read-timeout S            seconds, 1-3600\n"
+              << "  --write-timeout S           seconds, 1-3600\n"
+              << "  --device HOST:PORT          raw-socket printer; repeat for several\n"
+              << "  --workers N                 scheduler workers, 1-1024 (default: one per device)\n";
+}
+
+// Whole-string decimal in [min, max]; throws std::invalid_argument naming
+// the flag otherwise. Rejects signs, so "-1" can't wrap around.
+static std::uint64_t parse_number(const std::string& flag, const std::string& value,
+                                  std::uint64_t min, std::uint64_t max) {
+    const std::string expected = flag + " expects a number from " + std::to_string(min) + " to "
+                               + std::to_string(max) + ", got '" + value + "'";
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::invalid_argument(expected);
+    }
+    std::uint64_t v = 0;
+    try {
+        v = std::stoull(value);
+    } catch (const std::out_of_range&) {
+        throw std::invalid_argument(expected);
+    }
+    if (v < min || v > max) throw std::invalid_argument(expected);
+    return v;
+}
+
+// "host:port" of a raw-socket (port 9100) printer.
+static std::shared_ptr<printpipe::IBackend> socket_device(const std::string& spec) {
+    const auto colon = spec.rfind(':');
+    if (colon == std::string::npos || colon == 0) {
+        throw std::invalid_argument("--device expects HOST:PORT, got '" + spec + "'");
+    }
+    printpipe::SocketBackendOptions opts;
+    opts.host = spec.substr(0, colon);
+    opts.port = static_cast<std::uint16_t>(parse_number("--device port", spec.substr(colon + 1), 1, 65535));
+    return std::make_shared<printpipe::SocketBackend>(std::move(opts));
+}
+
 int main(int argc, char* argv[]) {
     int port = 8080;
-    
-    if (argc > 1) {
-        try {
-            port = std::stoi(argv[1]);
-        } catch (...) {
-            std::cerr << "Invalid port number. Using default: 8080\n";
+    std::string unix_socket;
+    printpipe::HttpFrontendConfig http;
+    printpipe::PrintDeviceConfig devices;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto number = [&](std::uint64_t min, std::uint64_t max) {
+                return parse_number(arg, argv[++i], min, max);
+            };
+            if (arg == "--help" || arg == "-h") {
+                usage(argv[0]);
+                return 0;
+            }
+            // ---- HTTP front end ----
+            if (arg == "--host" && i + 1 < argc) {
+                http.host = argv[++i];
+                continue;
+            }
+            if (arg == "--listeners" && i + 1 < argc) {
+                http.listeners = number(1, 64);
+                continue;
+            }
+            if (arg == "--threads" && i + 1 < argc) {
+                http.worker_threads = number(1, 4096);
+                continue;
+            }
+            if (arg == "--max-queued" && i + 1 < argc) {
+                http.max_queued_requests = number(0, 1000000);
+                continue;
+            }
+            if (arg == "--keep-alive-max" && i + 1 < argc) {
+                http.keep_alive_max_count = number(1, 1000000);
+                continue;
+            }
+            if (arg == "--keep-alive-timeout" && i + 1 < argc) {
+                http.keep_alive_timeout = std::chrono::seconds(number(1, 3600));
+                continue;
+            }
+            if (arg == "--read-timeout" && i + 1 < argc) {
+                http.read_timeout = std::chrono::seconds(number(1, 3600));
+                continue;
+            }
+            if (arg == "--write-timeout" && i + 1 < argc) {
+                http.write_timeout = std::chrono::seconds(number(1, 3600));
+                continue;
+            }
+            // ---- Print devices ----
+            if (arg == "--device" && i + 1 < argc) {
+                devices.backends.push_back(socket_device(argv[++i]));
+                continue;
+            }
+            if (arg == "--workers" && i + 1 < argc) {
+                devices.workers = number(1, 1024);
+                continue;
+            }
+            if (arg == "--unix-socket" && i + 1 < argc) {
+                unix_socket = argv[++i];
+                continue;
+            }
+            if (arg == "--log-level" && i + 1 < argc) {
+                const std::string level = argv[++i];
+                using printpipe::log::Level;
+                if (level == "debug") printpipe::log::set_level(Level::Debug);
+                else if (level == "info") printpipe::log::set_level(Level::Info);
+                else if (level == "warn") printpipe::log::set_level(Level::Warn);
+                else if (level == "error") printpipe::log::set_level(Level::Error);
+                else if (level == "off") printpipe::log::set_level(Level::Off);
+                else std::cerr << "Unknown log level '" << level << "', keeping info\n";
+                continue;
+            }
+            if (arg == "--log-rate" && i + 1 < argc) {
+                printpipe::log::set_rate_limit(static_cast<std::uint32_t>(number(0, 1000000)));
+                continue;
+            }
+            if (arg == "--trace") {
+                // Spans at GET /api/trace; SIGUSR1 also dumps them to a file
+                printpipe::trace::set_enabled(true);
+                printpipe::trace::dump_on_signal(SIGUSR1, "printpipe-trace.json");
+                continue;
+            }
+            if (arg.rfind("--", 0) == 0) {
+                throw std::invalid_argument("Unknown option or missing value: " + arg);
+            }
+            try {
+                port = std::stoi(arg);
+            } catch (...) {
+                std::cerr << "Invalid port number. Using default: 8080\n";
+            }
         }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n\n";
+        usage(argv[0]);
+        return 2;
     }
     
     // Set up signal handlers
@@ -31,7 +174,11 @@ int main(int argc, char* argv[]) {
     std::cout << "PrintPipe HTTP Server\n";
     std::cout << "=====================\n\n";
     
-    printpipe::PrintServer server(port);
+    printpipe::PrintServer server(port, "out", http, std::move(devices));
+    if (!unix_socket.empty() && !server.enable_local_socket(unix_socket)) {
+        std::cerr << "Could not listen on " << unix_socket << "\n";
+        return 1;
+    }
     
     std::cout << "Starting server on port " << port << "...\n";
     std::cout << "Press Ctrl+C to stop\n\n";
@@ -42,6 +189,7 @@ int main(int argc, char* argv[]) {
     std::cout << "  curl http://localhost:" << port << "/api/jobs\n\n";
     
     server.start();
+    printpipe::log::flush();
     
     return 0;
 }
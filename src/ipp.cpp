@@ -0,0 +1,320 @@
+#include "printpipe/ipp.hpp"
+
+#include <charconv>
+
+#include "printpipe/job_registry.hpp"
+#include "printpipe/scheduler.hpp"
+
+namespace printpipe {
+namespace ipp {
+
+namespace {
+
+std::uint16_t be16(const char* p) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<std::uint16_t>((u[0] << 8) | u[1]);
+}
+
+std::uint32_t be32(const char* p) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    return (static_cast<std::uint32_t>(u[0]) << 24) | (static_cast<std::uint32_t>(u[1]) << 16)
+         | (static_cast<std::uint32_t>(u[2]) << 8) | static_cast<std::uint32_t>(u[3]);
+}
+
+void put16(std::string& out, std::uint16_t v) {
+    out.push_back(static_cast<char>(v >> 8));
+    out.push_back(static_cast<char>(v & 0xff));
+}
+
+void put32(std::string& out, std::uint32_t v) {
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<char>((v >> shift) & 0xff));
+}
+
+} // namespace
+
+std::optional<std::int32_t> Attribute::integer() const noexcept {
+    if (value.size() != 4) return std::nullopt;
+    return static_cast<std::int32_t>(be32(value.data()));
+}
+
+const Attribute* Message::find(std::uint8_t group, std::string_view name) const noexcept {
+    for (const auto& a : attributes) {
+        if (a.group == group && a.name == name) return &a;
+    }
+    return nullptr;
+}
+
+ParseStatus parse_message(std::string_view data, Message& out, std::size_t& header_len) {
+    constexpr std::size_t kFixed = 8;   // version, code, request-id
+    if (data.size() < kFixed) return ParseStatus::NeedMore;
+
+    out.version_major = static_cast<std::uint8_t>(data[0]);
+    out.version_minor = static_cast<std::uint8_t>(data[1]);
+    out.code = be16(data.data() + 2);
+    out.request_id = be32(data.data() + 4);
+    out.attributes.clear();
+
+    std::size_t pos = kFixed;
+    std::uint8_t group = 0;
+    std::string_view last_name;
+    while (pos < data.size()) {
+        const auto t = static_cast<std::uint8_t>(data[pos]);
+
+        // ---- Delimiters ----
+        if (t < 0x10) {
+            ++pos;
+            if (t == tag::EndOfAttributes) {
+                header_len = pos;
+                return ParseStatus::Complete;
+            }
+            if (t == 0x00) return ParseStatus::Malformed;
+            group = t;
+            continue;
+        }
+
+        // ---- value-tag, name-length, name, value-length, value ----
+        if (group == 0) return ParseStatus::Malformed;
+        if (data.size() - pos < 3) return ParseStatus::NeedMore;
+        const std::size_t name_len = be16(data.data() + pos + 1);
+        if (data.size() - pos < 3 + name_len + 2) return ParseStatus::NeedMore;
+        const std::size_t value_len = be16(data.data() + pos + 3 + name_len);
+        const std::size_t total = 3 + name_len + 2 + value_len;
+        if (data.size() - pos < total) return ParseStatus::NeedMore;
+
+        std::string_view name = data.substr(pos + 3, name_len);
+        if (name.empty()) {
+            // Additional value of the previous attribute
+            if (last_name.empty()) return ParseStatus::Malformed;
+            name = last_name;
+        }
+        last_name = name;
+        out.attributes.push_back(Attribute{group, t, name, data.substr(pos + 5 + name_len, value_len)});
+        pos += total;
+    }
+    return ParseStatus::NeedMore;
+}
+
+MessageWriter::MessageWriter(std::uint16_t code, std::uint32_t request_id) {
+    out_.reserve(256);
+    out_.push_back(1);  // IPP/1.1
+    out_.push_back(1);
+    put16(out_, code);
+    put32(out_, request_id);
+}
+
+void MessageWriter::begin_group(std::uint8_t group_tag) {
+    out_.push_back(static_cast<char>(group_tag));
+}
+
+void MessageWriter::add(std::uint8_t value_tag, std::string_view name, std::string_view value) {
+    out_.push_back(static_cast<char>(value_tag));
+    put16(out_, static_cast<std::uint16_t>(name.size()));
+    out_.append(name);
+    put16(out_, static_cast<std::uint16_t>(value.size()));
+    out_.append(value);
+}
+
+void MessageWriter::add_integer(std::uint8_t value_tag, std::string_view name, std::int32_t value) {
+    out_.push_back(static_cast<char>(value_tag));
+    put16(out_, static_cast<std::uint16_t>(name.size()));
+    out_.append(name);
+    put16(out_, 4);
+    put32(out_, static_cast<std::uint32_t>(value));
+}
+
+std::string MessageWriter::finish() {
+    out_.push_back(static_cast<char>(tag::EndOfAttributes));
+    return std::move(out_);
+}
+
+std::int32_t job_state(JobState s) noexcept {
+    switch (s) {
+        case JobState::Created:   return 4;     // pending-held: not submitted yet
+        case JobState::Queued:
+        case JobState::Scheduled: return 3;     // pending
+        case JobState::Spooling:
+        case JobState::Printing:  return 5;     // processing
+        case JobState::Completed: return 9;
+        case JobState::Canceled:  return 7;
+        case JobState::Failed:    return 8;     // aborted
+    }
+    return 8;
+}
+
+} // namespace ipp
+
+namespace {
+
+ipp::MessageWriter begin_response(ipp::StatusCode status, std::uint32_t request_id) {
+    ipp::MessageWriter w(static_cast<std::uint16_t>(status), request_id);
+    w.begin_group(ipp::tag::OperationAttributes);
+    w.add(ipp::tag::Charset, "attributes-charset", "utf-8");
+    w.add(ipp::tag::NaturalLanguage, "attributes-natural-language", "en");
+    return w;
+}
+
+std::string error_response(ipp::StatusCode status, std::uint32_t request_id, std::string_view message) {
+    auto w = begin_response(status, request_id);
+    w.add(ipp::tag::TextWithoutLanguage, "status-message", message);
+    return w.finish();
+}
+
+} // namespace
+
+// ---- IppPrinter ----
+
+IppPrinter::IppPrinter(JobRegistry& registry, Scheduler& scheduler, std::string printer_uri)
+    : registry_(registry)
+    , scheduler_(scheduler)
+    , printer_uri_(std::move(printer_uri)) {}
+
+std::string IppPrinter::job_uri(JobId id) const {
+    return printer_uri_ + "/jobs/" + std::to_string(id);
+}
+
+std::shared_ptr<Job> IppPrinter::target_job(const ipp::Message& req) const {
+    JobId id = 0;
+    if (const auto* a = req.find(ipp::tag::OperationAttributes, "job-id"); a && a->integer()) {
+        id = static_cast<JobId>(*a->integer());
+    } else if (const auto* u = req.find(ipp::tag::OperationAttributes, "job-uri")) {
+        // .../jobs/<id>
+        const auto slash = u->value.rfind('/');
+        if (slash == std::string_view::npos) return nullptr;
+        const char* first = u->value.data() + slash + 1;
+        const char* last = u->value.data() + u->value.size();
+        if (std::from_chars(first, last, id).ec != std::errc{}) return nullptr;
+    } else {
+        return nullptr;
+    }
+    auto rec = registry_.find_by_job_id(id);
+    return rec ? rec->job : nullptr;
+}
+
+void IppPrinter::add_job_attributes(ipp::MessageWriter& w, const Job& job) const {
+    const JobState state = job.state();
+    w.begin_group(ipp::tag::JobAttributes);
+    w.add(ipp::tag::Uri, "job-uri", job_uri(job.id()));
+    w.add_integer(ipp::tag::Integer, "job-id", static_cast<std::int32_t>(job.id()));
+    w.add(ipp::tag::Uri, "job-printer-uri", printer_uri_);
+    w.add(ipp::tag::NameWithoutLanguage, "job-name", job.name());
+    w.add_integer(ipp::tag::Enum, "job-state", ipp::job_state(state));
+    w.add(ipp::tag::Keyword, "job-state-reasons",
+          state == JobState::Canceled ? "job-canceled-by-user"
+          : state == JobState::Completed ? "job-completed-successfully"
+          : state == JobState::Failed ? "aborted-by-system" : "none");
+}
+
+std::string IppPrinter::print_job(const ipp::Message& req, PayloadPtr document) {
+    if (!document) {
+        return error_response(ipp::StatusCode::ServerErrorInternalError, req.request_id, "Failed to store document");
+    }
+
+    std::string name = "untitled";
+    if (const auto* a = req.find(ipp::tag::OperationAttributes, "job-name")) name.assign(a->value);
+
+    JobRecord rec = registry_.create(name, std::move(document));
+    if (!scheduler_.submit(rec.job)) {
+        return error_response(ipp::StatusCode::ServerErrorInternalError, req.request_id, "Scheduler is not accepting jobs");
+    }
+    registry_.sweep();
+
+    auto w = begin_response(ipp::StatusCode::SuccessfulOk, req.request_id);
+    add_job_attributes(w, *rec.job);
+    return w.finish();
+}
+
+std::string IppPrinter::cancel_job(const ipp::Message& req) {
+    auto job = target_job(req);
+    if (!job) return error_response(ipp::StatusCode::ClientErrorNotFound, req.request_id, "Job not found");
+    // Job::cancel() is idempotent, but IPP reports finished jobs as not cancelable
+    if (Job::is_terminal(job->state()) || !job->cancel()) {
+        return error_response(ipp::StatusCode::ClientErrorNotPossible, req.request_id, "Job already finished");
+    }
+    return begin_response(ipp::StatusCode::SuccessfulOk, req.request_id).finish();
+}
+
+std::string IppPrinter::get_job_attributes(const ipp::Message& req) {
+    auto job = target_job(req);
+    if (!job) return error_response(ipp::StatusCode::ClientErrorNotFound, req.request_id, "Job not found");
+
+    auto w = begin_response(ipp::StatusCode::SuccessfulOk, req.request_id);
+    add_job_attributes(w, *job);
+    return w.finish();
+}
+
+// ---- IppPrinter::Exchange ----
+
+IppPrinter::Exchange::Exchange(IppPrinter& printer)
+    : printer_(printer) {}
+
+bool IppPrinter::Exchange::write(const char* data, std::size_t len) {
+    if (malformed_) return false;
+    if (parsed_) return write_document(data, len);
+
+    // ---- Attribute section: buffer until the end-of-attributes-tag ----
+    header_.append(data, len);
+    std::size_t header_len = 0;
+    switch (ipp::parse_message(header_, request_, header_len)) {
+        case ipp::ParseStatus::NeedMore:
+            if (header_.size() > kMaxHeaderBytes) malformed_ = true;
+            return !malformed_;
+        case ipp::ParseStatus::Malformed:
+            malformed_ = true;
+            return false;
+        case ipp::ParseStatus::Complete:
+            break;
+    }
+    parsed_ = true;
+
+    if (request_.code == static_cast<std::uint16_t>(ipp::Operation::PrintJob)) {
+        if (const auto& store = printer_.registry_.payload_store()) writer_.emplace(*store);
+    }
+    // Shrinking keeps the buffer, so the parsed views stay valid
+    const bool ok = write_document(header_.data() + header_len, header_.size() - header_len);
+    header_.resize(header_len);
+    return ok;
+}
+
+bool IppPrinter::Exchange::write_document(const char* data, std::size_t len) {
+    if (len == 0 || request_.code != static_cast<std::uint16_t>(ipp::Operation::PrintJob)) return true;
+    if (writer_) return writer_->append(data, len);
+    document_.append(data, len);
+    return true;
+}
+
+void IppPrinter::Exchange::abort() {
+    aborted_ = true;
+    writer_.reset();
+    std::string().swap(document_);
+}
+
+std::string IppPrinter::Exchange::finish() {
+    const std::uint32_t request_id = request_.request_id;
+    if (aborted_ && !malformed_) {
+        return error_response(ipp::StatusCode::ClientErrorBadRequest, request_id, "Incomplete IPP request");
+    }
+    if (malformed_ || !parsed_) {
+        return error_response(ipp::StatusCode::ClientErrorBadRequest, request_id, "Malformed IPP request");
+    }
+    if (request_.version_major != 1 && request_.version_major != 2) {
+        return error_response(ipp::StatusCode::ServerErrorVersionNotSupported, request_id, "Unsupported IPP version");
+    }
+    if (!request_.find(ipp::tag::OperationAttributes, "attributes-charset")
+        || !request_.find(ipp::tag::OperationAttributes, "attributes-natural-language")) {
+        return error_response(ipp::StatusCode::ClientErrorBadRequest, request_id, "Missing required operation attributes");
+    }
+
+    switch (static_cast<ipp::Operation>(request_.code)) {
+        case ipp::Operation::PrintJob:
+            return printer_.print_job(request_, writer_ ? writer_->finish() : Payload::from_string(std::move(document_)));
+        case ipp::Operation::ValidateJob:
+            return begin_response(ipp::StatusCode::SuccessfulOk, request_id).finish();
+        case ipp::Operation::CancelJob:
+            return printer_.cancel_job(request_);
+        case ipp::Operation::GetJobAttributes:
+            return printer_.get_job_attributes(request_);
+    }
+    return error_response(ipp::StatusCode::ServerErrorOperationNotSupported, request_id, "Operation not supported");
+}
+
+} // namespace printpipe
@@ -1,10 +1,22 @@
 #include "printpipe/job.hpp"
 #include "printpipe/event_bus.hpp"
 
+#include <thread>
+
 namespace printpipe {
 
+namespace {
+std::atomic<JobId> g_next_job_id{1};
+} // namespace
+
 Job::Job(std::string name)
-    : name_(std::move(name)) {}
+    : id_(g_next_job_id.fetch_add(1, std::memory_order_relaxed))
+    , name_(std::move(name))
+    , entered_at_(std::chrono::steady_clock::now().time_since_epoch().count()) {}
+
+JobId Job::id() const noexcept {
+    return id_;
+}
 
 const std::string& Job::name() const noexcept {
     return name_;
@@ -47,6 +59,7 @@ bool Job::is_valid_transition(JobState from, JobState to) noexcept {
 
         case JobState::Printing:
             return to == JobState::Completed
+                || to == JobState::Queued       // retry after a backend failure
                 || to == JobState::Canceled
                 || to == JobState::Failed;
 
@@ -65,12 +78,12 @@ TransitionResult Job::try_transition(JobState to) noexcept {
     if (!is_valid_transition(from, to)) {
         if (bus_) {
             bus_->publish(JobEvent{
+                .job_id = id_,
                 .kind = EventKind::RejectedTransition,
-                .job_name = name_,
                 .from = from,
                 .to = to,
-                .ts = std::chrono::steady_clock::now(),
-                .reason = "Transition not allowed by FSM"
+                .reason = ReasonCode::TransitionNotAllowed,
+                .ts = std::chrono::steady_clock::now()
             });
         }
         return {false, from, to};
@@ -81,6 +94,7 @@ TransitionResult Job::try_transition(JobState to) noexcept {
         return {true, from, to};
 
     // ---- CAS loop ----
+    const bool leaving_created = from == JobState::Created;
     while (!state_.compare_exchange_weak(
         from, to,
         std::memory_order_acq_rel,
@@ -89,27 +103,48 @@ TransitionResult Job::try_transition(JobState to) noexcept {
         if (!is_valid_transition(from, to)) {
             if (bus_) {
                 bus_->publish(JobEvent{
+                    .job_id = id_,
                     .kind = EventKind::RejectedTransition,
-                    .job_name = name_,
                     .from = from,
                     .to = to,
-                    .ts = std::chrono::steady_clock::now(),
-                    .reason = "Transition not allowed by FSM"
+                    .reason = ReasonCode::TransitionNotAllowed,
+                    .ts = std::chrono::steady_clock::now()
                 });
             }
             return {false, from, to};
         }
     }
 
+    if (leaving_created) {
+        // Pairs with the fence in set_payload_if_created(): either it sees
+        // the new state and backs off, or its swap finishes before we go on.
+        // Nothing transitions back into Created, so later states skip this.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (payload_swapping_.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
     // ---- Successful transition ----
+    const auto now = std::chrono::steady_clock::now();
+    const auto entered = entered_at_.exchange(now.time_since_epoch().count(), std::memory_order_relaxed);
+    if (to == JobState::Canceled) {
+        canceled_at_.store(now.time_since_epoch().count(), std::memory_order_release);
+        cancel_source_.request_stop();
+    }
+    if (is_terminal(to)) {
+        // Empty critical section orders the store before a waiter's check
+        { std::lock_guard<std::mutex> lk(wait_mu_); }
+        terminal_cv_.notify_all();
+    }
+
     if (bus_) {
         bus_->publish(JobEvent{
+            .job_id = id_,
             .kind = EventKind::StateChanged,
-            .job_name = name_,
             .from = from,
             .to = to,
-            .ts = std::chrono::steady_clock::now(),
-            .reason = {}
+            .reason = ReasonCode::None,
+            .ts = now,
+            .dwell = now - std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(entered))
         });
     }
 
@@ -123,6 +158,7 @@ bool Job::start_spooling() noexcept { return try_transition(JobState::Spooling).
 bool Job::start_printing() noexcept { return try_transition(JobState::Printing).ok; }
 bool Job::complete() noexcept       { return try_transition(JobState::Completed).ok; }
 bool Job::fail() noexcept           { return try_transition(JobState::Failed).ok; }
+bool Job::requeue() noexcept        { return try_transition(JobState::Queued).ok; }
 
 bool Job::cancel() noexcept {
     JobState s = state();
@@ -131,18 +167,70 @@ bool Job::cancel() noexcept {
     return try_transition(JobState::Canceled).ok;
 }
 
+JobState Job::wait_terminal(std::chrono::steady_clock::duration timeout) const {
+    std::unique_lock<std::mutex> lk(wait_mu_);
+    terminal_cv_.wait_for(lk, timeout, [&] { return is_terminal(state()); });
+    return state();
+}
+
+std::chrono::steady_clock::time_point Job::cancel_requested_at() const noexcept {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(canceled_at_.load(std::memory_order_acquire)));
+}
+
+void Job::set_event_bus(std::shared_ptr<EventBus> bus) {
+    bus_ = std::move(bus);
+    if (bus_) bus_->register_job(id_, name_);
+}
+
 void Job::set_payload(std::string data) {
+    set_payload(Payload::from_string(std::move(data)));
+}
+
+void Job::set_payload(PayloadPtr payload) {
     std::lock_guard<std::mutex> lk(payload_mu_);
-    payload_ = std::move(data);
+    payload_ = std::move(payload);
 }
 
-std::string Job::payload_copy() const {
+bool Job::set_payload_if_created(PayloadPtr payload) {
     std::lock_guard<std::mutex> lk(payload_mu_);
-    return payload_;
+    payload_swapping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool created = state() == JobState::Created;
+    if (created) payload_ = std::move(payload);
+    payload_swapping_.store(false, std::memory_order_release);
+    return created;
 }
 
+PayloadPtr Job::payload() const {
+    std::lock_guard<std::mutex> lk(payload_mu_);
+    return payload_;
+}
 
+std::string Job::payload_copy() const {
+    auto p = payload();
+    if (!p) return {};
+    auto view = p->view();
+    return std::string(view.data());
+}
 
+std::size_t Job::payload_size() const {
+    auto p = payload();
+    return p ? p->size() : 0;
+}
 
+const char* job_state_to_string(JobState s) noexcept {
+    switch (s) {
+        case JobState::Created:   return "created";
+        case JobState::Queued:    return "queued";
+        case JobState::Scheduled: return "scheduled";
+        case JobState::Spooling:  return "spooling";
+        case JobState::Printing:  return "printing";
+        case JobState::Completed: return "completed";
+        case JobState::Canceled:  return "canceled";
+        case JobState::Failed:    return "failed";
+    }
+    return "unknown";
+}
 
 } // namespace printpipe
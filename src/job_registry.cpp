@@ -0,0 +1,186 @@
+#include "printpipe/job_registry.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+namespace printpipe {
+
+namespace {
+// How many pending completions to fold in per registry lock acquisition.
+constexpr std::size_t kAdmitBatch = 256;
+// Evictions per timer-driven sweep call.
+constexpr std::size_t kTimerBatch = 64;
+} // namespace
+
+JobRegistry::JobRegistry(std::filesystem::path output_dir, std::shared_ptr<EventBus> bus)
+    : output_dir_(std::move(output_dir))
+    , bus_(std::move(bus))
+    , finished_(std::make_shared<FinishedLog>())
+{
+    if (bus_) {
+        bus_->subscribe([log = finished_](const JobEvent& ev) {
+            if (ev.kind != EventKind::StateChanged || !Job::is_terminal(ev.to)) return;
+            std::lock_guard<std::mutex> lk(log->mu);
+            log->pending.push_back(Finished{ev.job_id, ev.ts});
+        });
+    }
+}
+
+JobRecord JobRegistry::create(const std::string& name, std::string payload) {
+    return create(name, payload_store_ ? payload_store_->store(std::move(payload))
+                                       : Payload::from_string(std::move(payload)));
+}
+
+JobRecord JobRegistry::create(const std::string& name, PayloadPtr payload) {
+    auto job = std::make_shared<Job>(name);
+    job->set_event_bus(bus_);
+    job->set_payload(std::move(payload));
+
+    std::ostringstream oss;
+    oss << "job-" << std::setfill('0') << std::setw(6)
+        << counter_.fetch_add(1, std::memory_order_relaxed);
+
+    JobRecord rec{oss.str(), std::move(job), output_dir_ / (name + ".txt")};
+
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = jobs_.emplace(rec.id, rec).first;
+    by_job_id_.emplace(rec.job->id(), it);
+    ++output_refs_[rec.output_file.native()];
+    return rec;
+}
+
+std::optional<JobRecord> JobRegistry::find(const std::string& id) const {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    return it->second;
+}
+
+std::optional<JobRecord> JobRegistry::find_by_job_id(JobId id) const {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = by_job_id_.find(id);
+    if (it == by_job_id_.end()) return std::nullopt;
+    return it->second->second;
+}
+
+std::vector<JobRecord> JobRegistry::list() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::vector<JobRecord> out;
+    out.reserve(jobs_.size());
+    for (const auto& [_, rec] : jobs_) out.push_back(rec);
+    return out;
+}
+
+std::size_t JobRegistry::size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return jobs_.size();
+}
+
+std::size_t JobRegistry::retained_bytes() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return retained_bytes_;
+}
+
+void JobRegistry::set_retention_policy(RetentionPolicy policy) {
+    std::lock_guard<std::mutex> lk(mu_);
+    policy_ = policy;
+}
+
+std::size_t JobRegistry::footprint(const JobRecord& rec) {
+    auto payload = rec.job->payload();
+    return sizeof(Job) + sizeof(JobRecord) + rec.id.capacity()
+         + rec.job->name().capacity() + (payload ? payload->resident_bytes() : 0)
+         + rec.output_file.native().capacity();
+}
+
+bool JobRegistry::over_limits(const Retained& oldest, Clock::time_point now) const {
+    if (policy_.max_terminal_jobs != 0 && retained_.size() > policy_.max_terminal_jobs)
+        return true;
+    if (policy_.max_bytes != 0 && retained_bytes_ > policy_.max_bytes)
+        return true;
+    if (policy_.max_age != Clock::duration::zero() && now - oldest.at > policy_.max_age)
+        return true;
+    return false;
+}
+
+std::size_t JobRegistry::sweep(std::size_t max_evictions) {
+    std::unique_lock<std::mutex> sweeping(sweep_mu_, std::try_to_lock);
+    if (!sweeping.owns_lock()) return 0;    // another thread is already on it
+
+    std::vector<Finished> fresh;
+    {
+        std::lock_guard<std::mutex> lk(finished_->mu);
+        fresh.swap(finished_->pending);
+    }
+
+    // ---- Admit newly finished jobs, in short lock holds ----
+    for (std::size_t i = 0; i < fresh.size(); i += kAdmitBatch) {
+        const std::size_t end = std::min(fresh.size(), i + kAdmitBatch);
+        std::lock_guard<std::mutex> lk(mu_);
+        for (std::size_t k = i; k < end; ++k) {
+            auto it = by_job_id_.find(fresh[k].job_id);
+            if (it == by_job_id_.end()) continue;   // not one of ours
+            const std::size_t bytes = footprint(it->second->second);
+            retained_.push_back(Retained{fresh[k].job_id, fresh[k].at, bytes});
+            retained_bytes_ += bytes;
+        }
+    }
+
+    // ---- Evict from the oldest end ----
+    std::vector<JobRecord> evicted;
+    std::vector<std::filesystem::path> orphaned;    // output no record refers to
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        const bool delete_files = policy_.delete_output_files;
+        const auto now = Clock::now();
+        while (evicted.size() < max_evictions
+               && !retained_.empty()
+               && over_limits(retained_.front(), now)) {
+            const Retained oldest = retained_.front();
+            retained_.pop_front();
+            retained_bytes_ -= oldest.bytes;
+
+            auto it = by_job_id_.find(oldest.job_id);
+            if (it == by_job_id_.end()) continue;
+            evicted.push_back(std::move(it->second->second));
+            jobs_.erase(it->second);
+            by_job_id_.erase(it);
+
+            auto ref = output_refs_.find(evicted.back().output_file.native());
+            if (ref != output_refs_.end() && --ref->second == 0) {
+                output_refs_.erase(ref);
+                if (delete_files) orphaned.push_back(evicted.back().output_file);
+            }
+        }
+    }
+
+    // ---- Release everything else outside the registry lock ----
+    for (const auto& rec : evicted) {
+        if (bus_) bus_->retire(rec.job->id());
+    }
+    for (const auto& path : orphaned) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+    return evicted.size();
+}
+
+void JobRegistry::sweep_every(std::chrono::milliseconds interval) {
+    timer_ = std::jthread([this, interval](std::stop_token stop) {
+        std::unique_lock<std::mutex> lk(timer_mu_);
+        while (!stop.stop_requested()) {
+            timer_cv_.wait_for(lk, stop, interval, [] { return false; });
+            if (stop.stop_requested()) break;
+            lk.unlock();
+            // Keep going while whole batches come back; the next tick picks
+            // up anything left if a request-path sweep holds the lock
+            while (sweep(kTimerBatch) == kTimerBatch && !stop.stop_requested()) {
+            }
+            lk.lock();
+        }
+    });
+}
+
+} // namespace printpipe
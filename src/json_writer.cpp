@@ -0,0 +1,178 @@
+#include "printpipe/json_writer.hpp"
+
+#include <charconv>
+#include <cmath>
+
+namespace printpipe {
+
+namespace {
+
+constexpr char kHex[] = "0123456789abcdef";
+constexpr std::string_view kReplacement = "\xef\xbf\xbd";   // U+FFFD
+
+// Length of the well-formed UTF-8 sequence starting at s[i], or 0. When
+// the sequence is malformed, `bad` is set to the bytes it spans up to (not
+// including) the first offending byte, which the caller re-examines; this
+// gives the same U+FFFD substitutions as nlohmann's error_handler_t::replace.
+std::size_t utf8_sequence(std::string_view s, std::size_t i, std::size_t& bad) {
+    const auto c = static_cast<unsigned char>(s[i]);
+    std::size_t len = 0;
+    unsigned char lo = 0x80, hi = 0xbf;     // allowed range of the second byte
+    if (c >= 0xc2 && c <= 0xdf) {
+        len = 2;
+    } else if (c >= 0xe0 && c <= 0xef) {
+        len = 3;
+        if (c == 0xe0) lo = 0xa0;
+        if (c == 0xed) hi = 0x9f;           // no UTF-16 surrogates
+    } else if (c >= 0xf0 && c <= 0xf4) {
+        len = 4;
+        if (c == 0xf0) lo = 0x90;
+        if (c == 0xf4) hi = 0x8f;           // nothing above U+10FFFF
+    } else {
+        bad = 1;
+        return 0;
+    }
+    for (std::size_t k = 1; k < len; ++k) {
+        if (i + k == s.size()) {
+            bad = k;                        // truncated at the end of the string
+            return 0;
+        }
+        const auto b = static_cast<unsigned char>(s[i + k]);
+        if (b < (k == 1 ? lo : 0x80) || b > (k == 1 ? hi : 0xbf)) {
+            bad = k;
+            return 0;
+        }
+    }
+    return len;
+}
+
+} // namespace
+
+JsonWriter& JsonWriter::open(char bracket) {
+    before_value();
+    out_.push_back(bracket);
+    ++depth_;
+    has_items_ &= ~(std::uint64_t{1} << ((depth_ - 1) & 63));
+    return *this;
+}
+
+JsonWriter& JsonWriter::close(char bracket) {
+    const bool had_items = has_items_ & (std::uint64_t{1} << ((depth_ - 1) & 63));
+    --depth_;
+    if (had_items) newline_indent();
+    out_.push_back(bracket);
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view k) {
+    before_value();
+    write_string(k);
+    out_.append(pretty_ ? ": " : ":");
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view s) {
+    before_value();
+    write_string(s);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b) {
+    before_value();
+    out_.append(b ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::int64_t n) {
+    before_value();
+    char buf[24];
+    const auto r = std::to_chars(buf, buf + sizeof(buf), n);
+    out_.append(buf, r.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::uint64_t n) {
+    before_value();
+    char buf[24];
+    const auto r = std::to_chars(buf, buf + sizeof(buf), n);
+    out_.append(buf, r.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double d) {
+    if (!std::isfinite(d)) return null();   // as nlohmann does
+    before_value();
+    char buf[32];
+    const auto r = std::to_chars(buf, buf + sizeof(buf), d);
+    out_.append(buf, r.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    before_value();
+    out_.append("null");
+    return *this;
+}
+
+// Separator and indentation owed before the next key or value.
+void JsonWriter::before_value() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (depth_ == 0) return;
+    const std::uint64_t bit = std::uint64_t{1} << ((depth_ - 1) & 63);
+    if (has_items_ & bit) out_.push_back(',');
+    has_items_ |= bit;
+    newline_indent();
+}
+
+void JsonWriter::newline_indent() {
+    if (!pretty_) return;
+    out_.push_back('\n');
+    out_.append(2 * static_cast<std::size_t>(depth_), ' ');
+}
+
+void JsonWriter::write_string(std::string_view s) {
+    out_.push_back('"');
+    std::size_t run = 0;    // start of the pending unescaped run
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        const auto c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x80) {
+            // Valid multi-byte sequences pass through; anything else becomes
+            // U+FFFD so the output stays valid JSON text.
+            std::size_t bad = 0;
+            if (const std::size_t len = utf8_sequence(s, i, bad)) {
+                i += len - 1;
+                continue;
+            }
+            out_.append(s.data() + run, i - run);
+            out_.append(kReplacement);
+            i += bad - 1;
+            run = i + 1;
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out_.append(s.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  out_.append("\\\""); break;
+            case '\\': out_.append("\\\\"); break;
+            case '\b': out_.append("\\b"); break;
+            case '\f': out_.append("\\f"); break;
+            case '\n': out_.append("\\n"); break;
+            case '\r': out_.append("\\r"); break;
+            case '\t': out_.append("\\t"); break;
+            default: {
+                const char esc[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+                out_.append(esc, sizeof(esc));
+            }
+        }
+    }
+    out_.append(s.data() + run, s.size() - run);
+    out_.push_back('"');
+}
+
+} // namespace printpipe
@@ -0,0 +1,560 @@
+#include "printpipe/local_submit.hpp"
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#include "printpipe/job_registry.hpp"
+#include "printpipe/payload.hpp"
+#include "printpipe/scheduler.hpp"
+
+namespace printpipe {
+
+using local_proto::Op;
+using local_proto::PayloadMode;
+using local_proto::Status;
+
+namespace {
+
+constexpr std::size_t kHeaderSize = 5;                  // u32 length + u8 op/status
+constexpr std::uint32_t kMaxControlBody = 4096;         // non-payload requests
+constexpr std::size_t kCopyChunk = 64 * 1024;
+constexpr std::size_t kMaxPassedFds = 8;                // per message; one is allowed
+constexpr auto kWaitSlice = std::chrono::milliseconds(100);
+
+void put_u16(std::string& out, std::uint16_t v) {
+    out.push_back(static_cast<char>(v & 0xff));
+    out.push_back(static_cast<char>(v >> 8));
+}
+
+void put_u32(std::string& out, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+std::uint16_t get_u16(const unsigned char* p) {
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+std::uint32_t get_u32(const unsigned char* p) {
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8)
+         | (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+bool read_exact(int fd, void* buf, std::size_t n) {
+    auto* p = static_cast<char*>(buf);
+    while (n > 0) {
+        const ssize_t r = ::recv(fd, p, n, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+bool write_all(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+        const ssize_t r = ::send(fd, p, n, MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+// Reads a frame header, collecting a descriptor passed alongside it. Sets
+// `bad_fds` (and closes whatever arrived) when the message carried more than
+// one descriptor or the kernel had to truncate them.
+bool recv_header(int fd, unsigned char (&hdr)[kHeaderSize], int& passed_fd, bool& bad_fds) {
+    passed_fd = -1;
+    bad_fds = false;
+    // Room for a few, so extras are received (and closed) rather than lost
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxPassedFds)];
+    iovec iov{hdr, kHeaderSize};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t r;
+    do {
+        r = ::recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+    } while (r < 0 && errno == EINTR);
+    if (r <= 0) return false;
+
+    std::vector<int> received;
+    for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+        const std::size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (std::size_t i = 0; i < count; ++i) {
+            int passed;
+            std::memcpy(&passed, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+            received.push_back(passed);
+        }
+    }
+    if ((msg.msg_flags & MSG_CTRUNC) || received.size() > 1) {
+        for (int f : received) ::close(f);
+        bad_fds = true;
+    } else if (!received.empty()) {
+        passed_fd = received.front();
+    }
+    return read_exact(fd, hdr + r, kHeaderSize - static_cast<std::size_t>(r));
+}
+
+bool reply(int fd, Status status, std::string_view body = {}) {
+    std::string out;
+    out.reserve(kHeaderSize + body.size());
+    put_u32(out, static_cast<std::uint32_t>(1 + body.size()));
+    out.push_back(static_cast<char>(status));
+    out.append(body);
+    return write_all(fd, out.data(), out.size());
+}
+
+// Unsealed regular files are copied: the producer keeps write access, so
+// mapping them would let it truncate (SIGBUS) or edit the submitted document.
+PayloadPtr copy_document(int fd, PayloadStore* store) {
+    std::optional<PayloadWriter> writer;
+    std::string data;
+    if (store) writer.emplace(*store);
+    char chunk[kCopyChunk];
+    off_t offset = 0;
+    for (;;) {
+        const ssize_t r = ::pread(fd, chunk, sizeof(chunk), offset);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0) return nullptr;
+        if (r == 0) break;
+        const auto n = static_cast<std::size_t>(r);
+        if (writer) {
+            if (!writer->append(chunk, n)) return nullptr;
+        } else {
+            data.append(chunk, n);
+        }
+        offset += r;
+    }
+    return writer ? writer->finish() : Payload::from_string(std::move(data));
+}
+
+bool regular_file(int fd) {
+    struct stat st{};
+    return ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+struct FdGuard {
+    int fd;
+    ~FdGuard() { if (fd >= 0) ::close(fd); }
+};
+
+} // namespace
+
+// ---- LocalSubmitServer ----
+
+LocalSubmitServer::LocalSubmitServer(std::filesystem::path socket_path, JobRegistry& registry,
+                                     Scheduler& scheduler)
+    : path_(std::move(socket_path))
+    , registry_(registry)
+    , scheduler_(scheduler) {}
+
+LocalSubmitServer::~LocalSubmitServer() {
+    stop();
+}
+
+bool LocalSubmitServer::start() {
+    if (listen_fd_ >= 0) return true;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const auto& native = path_.native();
+    if (native.empty() || native.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, native.c_str(), native.size() + 1);
+
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    // bind() honors the umask, which usually lets anyone connect; restrict
+    // the socket before it accepts anything
+    std::filesystem::permissions(path_, perms_, std::filesystem::perm_options::replace, ec);
+    if (ec || ::listen(fd, 64) != 0) {
+        ::close(fd);
+        std::filesystem::remove(path_, ec);
+        return false;
+    }
+
+    wake_fd_ = ::eventfd(0, EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    stopping_.store(false);
+    acceptor_ = std::thread([this] { accept_loop(); });
+    return true;
+}
+
+void LocalSubmitServer::stop() {
+    if (listen_fd_ < 0) return;
+
+    stopping_.store(true);
+    const std::uint64_t one = 1;
+    (void)!::write(wake_fd_, &one, sizeof(one));
+    if (acceptor_.joinable()) acceptor_.join();
+
+    std::list<Connection> conns;
+    {
+        std::lock_guard<std::mutex> lk(conns_mu_);
+        // Unblock connection threads sitting in recv()
+        for (auto& c : conns_) {
+            if (!c.done) ::shutdown(c.fd, SHUT_RDWR);
+        }
+        conns.swap(conns_);
+    }
+    for (auto& c : conns) {
+        if (c.thread.joinable()) c.thread.join();
+    }
+
+    ::close(listen_fd_);
+    ::close(wake_fd_);
+    listen_fd_ = -1;
+    wake_fd_ = -1;
+
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+}
+
+void LocalSubmitServer::accept_loop() {
+    while (!stopping_.load()) {
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        int c = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (c < 0) continue;
+
+        std::lock_guard<std::mutex> lk(conns_mu_);
+        if (stopping_.load()) {
+            ::close(c);
+            break;
+        }
+        // Reap connections that have already closed
+        for (auto it = conns_.begin(); it != conns_.end();) {
+            if (!it->done) {
+                ++it;
+                continue;
+            }
+            it->thread.join();
+            it = conns_.erase(it);
+        }
+        Connection& conn = conns_.emplace_back();
+        conn.fd = c;
+        conn.thread = std::thread([this, &conn] { serve(conn); });
+    }
+}
+
+void LocalSubmitServer::serve(Connection& conn) {
+    const int fd = conn.fd;
+    // Every exit path closes the socket and marks the slot for reaping
+    struct Release {
+        LocalSubmitServer& self;
+        Connection& conn;
+        ~Release() {
+            std::lock_guard<std::mutex> lk(self.conns_mu_);
+            ::close(conn.fd);
+            conn.done = true;
+        }
+    } release{*this, conn};
+
+    std::vector<unsigned char> body;
+
+    for (;;) {
+        unsigned char hdr[kHeaderSize];
+        int passed = -1;
+        bool bad_fds = false;
+        if (!recv_header(fd, hdr, passed, bad_fds)) break;
+        FdGuard passed_guard{passed};
+        if (bad_fds) {
+            // The body was not read, so the stream can't be resynchronized
+            (void)reply(fd, Status::BadRequest);
+            break;
+        }
+
+        const std::uint32_t len = get_u32(hdr);
+        const auto op = static_cast<Op>(hdr[4]);
+        if (len == 0 || len > local_proto::kMaxFrame) {
+            (void)reply(fd, Status::BadRequest);
+            break;
+        }
+        std::uint32_t left = len - 1;
+
+        // ---- CreateSubmit: stream the payload instead of buffering the frame ----
+        if (op == Op::CreateSubmit) {
+            unsigned char name_len_buf[2];
+            if (left < 3 || !read_exact(fd, name_len_buf, 2)) break;
+            const std::uint16_t name_len = get_u16(name_len_buf);
+            left -= 2;
+            if (left < name_len + 1u) {
+                (void)reply(fd, Status::BadRequest);
+                break;
+            }
+            std::string name(name_len, '\0');
+            unsigned char mode = 0;
+            if (!read_exact(fd, name.data(), name_len) || !read_exact(fd, &mode, 1)) break;
+            left -= name_len + 1u;
+
+            PayloadPtr payload;
+            if (static_cast<PayloadMode>(mode) == PayloadMode::Fd) {
+                if (passed < 0 || left != 0) {
+                    (void)reply(fd, Status::BadRequest);
+                    break;
+                }
+                // Pipes, sockets and the like have no size to map or copy
+                if (!regular_file(passed)) {
+                    if (!reply(fd, Status::BadRequest)) break;
+                    continue;
+                }
+                payload = Payload::sealed_fd(passed) ? Payload::from_fd(passed)
+                                                     : copy_document(passed, registry_.payload_store().get());
+            } else if (static_cast<PayloadMode>(mode) == PayloadMode::Inline) {
+                std::optional<PayloadWriter> writer;
+                std::string inline_data;
+                if (registry_.payload_store()) writer.emplace(*registry_.payload_store());
+                char chunk[kCopyChunk];
+                bool ok = true;
+                while (left > 0 && ok) {
+                    const auto n = std::min<std::size_t>(left, sizeof(chunk));
+                    if (!read_exact(fd, chunk, n)) return;      // peer went away
+                    ok = writer ? writer->append(chunk, n) : (inline_data.append(chunk, n), true);
+                    left -= static_cast<std::uint32_t>(n);
+                }
+                if (ok) payload = writer ? writer->finish() : Payload::from_string(std::move(inline_data));
+                // Keep the stream in sync even if storing failed
+                while (left > 0) {
+                    const auto n = std::min<std::size_t>(left, sizeof(chunk));
+                    if (!read_exact(fd, chunk, n)) return;
+                    left -= static_cast<std::uint32_t>(n);
+                }
+            } else {
+                (void)reply(fd, Status::BadRequest);
+                break;
+            }
+
+            if (!payload) {
+                if (!reply(fd, Status::Error)) break;
+                continue;
+            }
+
+            JobRecord rec = registry_.create(name, std::move(payload));
+            // Retire finished jobs incrementally, as the HTTP and IPP paths do
+            registry_.sweep();
+            if (!scheduler_.submit(rec.job)) {
+                if (!reply(fd, Status::Error)) break;
+                continue;
+            }
+            std::string out;
+            put_u16(out, static_cast<std::uint16_t>(rec.id.size()));
+            out.append(rec.id);
+            if (!reply(fd, Status::Ok, out)) break;
+            continue;
+        }
+
+        // ---- Control requests: small, read whole ----
+        if (left > kMaxControlBody) {
+            (void)reply(fd, Status::BadRequest);
+            break;
+        }
+        body.resize(left);
+        if (!read_exact(fd, body.data(), body.size())) break;
+
+        const unsigned char* p = body.data();
+        std::size_t n = body.size();
+        std::uint32_t timeout_ms = 0;
+        if (op == Op::Wait) {
+            if (n < 4) { (void)reply(fd, Status::BadRequest); break; }
+            timeout_ms = get_u32(p);
+            p += 4;
+            n -= 4;
+        } else if (op != Op::Status) {
+            (void)reply(fd, Status::BadRequest);
+            break;
+        }
+        if (n < 2 || n - 2 != get_u16(p)) {
+            (void)reply(fd, Status::BadRequest);
+            break;
+        }
+        const std::string id(reinterpret_cast<const char*>(p + 2), n - 2);
+
+        auto rec = registry_.find(id);
+        if (!rec) {
+            if (!reply(fd, Status::NotFound)) break;
+            continue;
+        }
+
+        JobState state = rec->job->state();
+        if (op == Op::Wait) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            while (!Job::is_terminal(state) && !stopping_.load()) {
+                const auto now = std::chrono::steady_clock::now();
+                if (now >= deadline) break;
+                state = rec->job->wait_terminal(std::min<std::chrono::steady_clock::duration>(deadline - now, kWaitSlice));
+            }
+        }
+        const char s = static_cast<char>(state);
+        const Status status = (op == Op::Wait && !Job::is_terminal(state)) ? Status::Timeout : Status::Ok;
+        if (!reply(fd, status, std::string_view(&s, 1))) break;
+    }
+}
+
+// ---- LocalSubmitClient ----
+
+LocalSubmitClient::~LocalSubmitClient() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool LocalSubmitClient::connect(const std::filesystem::path& socket_path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const auto& native = socket_path.native();
+    if (native.empty() || native.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, native.c_str(), native.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = fd;
+    return true;
+}
+
+bool LocalSubmitClient::send_frame(std::string_view head, std::string_view tail, int pass_fd) {
+    if (fd_ < 0) return false;
+    const std::size_t total = head.size() + tail.size();
+    if (total > local_proto::kMaxFrame) return false;
+
+    std::string prefix;
+    put_u32(prefix, static_cast<std::uint32_t>(total));
+    prefix.append(head);
+
+    iovec iov[2] = {{prefix.data(), prefix.size()}, {const_cast<char*>(tail.data()), tail.size()}};
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = tail.empty() ? 1 : 2;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    if (pass_fd >= 0) {
+        std::memset(control, 0, sizeof(control));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(c), &pass_fd, sizeof(int));
+    }
+
+    ssize_t r;
+    do {
+        r = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+    } while (r < 0 && errno == EINTR);
+    if (r < 0) return false;
+
+    // Finish a short write; the descriptor already went with the first bytes
+    std::size_t sent = static_cast<std::size_t>(r);
+    if (sent < prefix.size()) {
+        if (!write_all(fd_, prefix.data() + sent, prefix.size() - sent)) return false;
+        sent = prefix.size();
+    }
+    const std::size_t tail_sent = sent - prefix.size();
+    return write_all(fd_, tail.data() + tail_sent, tail.size() - tail_sent);
+}
+
+std::optional<std::string> LocalSubmitClient::read_reply(Status& status) {
+    unsigned char hdr[kHeaderSize];
+    if (fd_ < 0 || !read_exact(fd_, hdr, kHeaderSize)) return std::nullopt;
+    const std::uint32_t len = get_u32(hdr);
+    if (len == 0 || len > kMaxControlBody) return std::nullopt;
+    status = static_cast<Status>(hdr[4]);
+    std::string body(len - 1, '\0');
+    if (!read_exact(fd_, body.data(), body.size())) return std::nullopt;
+    return body;
+}
+
+std::optional<std::string> LocalSubmitClient::submit(std::string_view name, std::string_view payload) {
+    std::string head;
+    head.push_back(static_cast<char>(Op::CreateSubmit));
+    put_u16(head, static_cast<std::uint16_t>(name.size()));
+    head.append(name);
+    head.push_back(static_cast<char>(PayloadMode::Inline));
+    if (!send_frame(head, payload, -1)) return std::nullopt;
+
+    Status status{};
+    auto body = read_reply(status);
+    if (!body || status != Status::Ok || body->size() < 2) return std::nullopt;
+    return body->substr(2);
+}
+
+std::optional<std::string> LocalSubmitClient::submit_fd(std::string_view name, int document_fd) {
+    std::string head;
+    head.push_back(static_cast<char>(Op::CreateSubmit));
+    put_u16(head, static_cast<std::uint16_t>(name.size()));
+    head.append(name);
+    head.push_back(static_cast<char>(PayloadMode::Fd));
+    if (!send_frame(head, {}, document_fd)) return std::nullopt;
+
+    Status status{};
+    auto body = read_reply(status);
+    if (!body || status != Status::Ok || body->size() < 2) return std::nullopt;
+    return body->substr(2);
+}
+
+std::optional<JobState> LocalSubmitClient::state_request(Op op, std::string_view body) {
+    std::string head;
+    head.push_back(static_cast<char>(op));
+    if (!send_frame(head, body, -1)) return std::nullopt;
+
+    Status status{};
+    auto reply_body = read_reply(status);
+    if (!reply_body || reply_body->size() != 1) return std::nullopt;
+    if (status != Status::Ok && status != Status::Timeout) return std::nullopt;
+    return static_cast<JobState>((*reply_body)[0]);
+}
+
+std::optional<JobState> LocalSubmitClient::status(std::string_view job_id) {
+    std::string body;
+    put_u16(body, static_cast<std::uint16_t>(job_id.size()));
+    body.append(job_id);
+    return state_request(Op::Status, body);
+}
+
+std::optional<JobState> LocalSubmitClient::wait(std::string_view job_id, std::chrono::milliseconds timeout) {
+    std::string body;
+    put_u32(body, static_cast<std::uint32_t>(timeout.count()));
+    put_u16(body, static_cast<std::uint16_t>(job_id.size()));
+    body.append(job_id);
+    return state_request(Op::Wait, body);
+}
+
+} // namespace printpipe
@@ -0,0 +1,284 @@
+#include "printpipe/log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace printpipe {
+namespace log {
+
+namespace detail {
+std::atomic<Level> g_level{Level::Info};
+} // namespace detail
+
+namespace {
+
+constexpr std::size_t kQueueSize = 4096;    // power of two
+
+struct Record {
+    std::int64_t ts_ns;         // system_clock
+    Level level;
+    std::uint16_t len;
+    char text[kMaxMessage];
+};
+
+// Bounded MPMC queue (Vyukov): each cell's sequence number says whether it
+// is free for the producer at `pos` or holds data for the consumer at `pos`.
+class RecordQueue {
+public:
+    RecordQueue() : cells_(std::make_unique<Cell[]>(kQueueSize)) {
+        for (std::size_t i = 0; i < kQueueSize; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Claims a slot and lets `fill` write the record in place.
+    template <typename Fill>
+    bool try_push(Fill&& fill) {
+        std::uint64_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & (kQueueSize - 1)];
+            const std::uint64_t seq = c.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(c.rec);
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(Record& out) {
+        std::uint64_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & (kQueueSize - 1)];
+            const std::uint64_t seq = c.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = c.rec;
+                    c.seq.store(pos + kQueueSize, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::uint64_t claimed() const noexcept { return tail_.load(std::memory_order_acquire); }
+
+private:
+    struct Cell {
+        std::atomic<std::uint64_t> seq;
+        Record rec;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+};
+
+struct State {
+    RecordQueue queue;
+    std::atomic<std::FILE*> sink{stdout};
+
+    std::atomic<std::uint32_t> rate_limit{0};
+    std::atomic<std::int64_t> rate_window{0};
+    std::atomic<std::uint32_t> rate_count{0};
+
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> dropped_full{0};
+    std::atomic<std::uint64_t> dropped_rate{0};
+
+    // Writer sleep/wake without a lock on the producer side
+    std::atomic<bool> sleeping{false};
+    std::atomic<std::uint32_t> wake{0};
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> started{false};
+    std::thread writer;
+};
+
+// Leaked on purpose so late loggers never touch a destroyed queue; the
+// writer is stopped and drained from an atexit handler instead.
+State& state() {
+    static State* s = new State;
+    return *s;
+}
+
+std::once_flag g_started;
+
+const char* level_name(Level level) {
+    switch (level) {
+        case Level::Debug: return "DEBUG";
+        case Level::Info:  return "INFO ";
+        case Level::Warn:  return "WARN ";
+        case Level::Error: return "ERROR";
+        case Level::Off:   break;
+    }
+    return "     ";
+}
+
+void emit(std::FILE* out, const Record& r) {
+    const std::time_t secs = static_cast<std::time_t>(r.ts_ns / 1000000000);
+    std::tm tm{};
+    gmtime_r(&secs, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+    std::fprintf(out, "%s.%03dZ %s %.*s\n", stamp, static_cast<int>((r.ts_ns / 1000000) % 1000),
+                 level_name(r.level), static_cast<int>(r.len), r.text);
+}
+
+void wake_writer(State& s) {
+    s.wake.fetch_add(1, std::memory_order_release);
+    s.wake.notify_one();
+}
+
+void writer_loop() {
+    State& s = state();
+    Record r;
+    std::uint64_t reported_drops = 0;
+
+    for (;;) {
+        std::FILE* out = s.sink.load(std::memory_order_acquire);
+        bool any = false;
+        while (s.queue.try_pop(r)) {
+            emit(out, r);
+            s.written.fetch_add(1, std::memory_order_release);
+            any = true;
+        }
+
+        const std::uint64_t drops = s.dropped_full.load(std::memory_order_relaxed)
+                                  + s.dropped_rate.load(std::memory_order_relaxed);
+        if (drops != reported_drops) {
+            std::fprintf(out, "[log] dropped %llu records\n", static_cast<unsigned long long>(drops - reported_drops));
+            reported_drops = drops;
+            any = true;
+        }
+        if (any) std::fflush(out);
+
+        if (s.stopping.load(std::memory_order_acquire)) {
+            if (!s.queue.try_pop(r)) return;
+            emit(out, r);
+            s.written.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+
+        // ---- Sleep until a producer finds us idle ----
+        const std::uint32_t w = s.wake.load(std::memory_order_acquire);
+        s.sleeping.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // Claimed but unwritten records mean a producer is mid-push: spin
+        if (s.queue.claimed() == s.written.load(std::memory_order_relaxed) && !s.stopping.load()) {
+            s.wake.wait(w, std::memory_order_acquire);
+        }
+        s.sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void stop_writer() {
+    State& s = state();
+    s.stopping.store(true, std::memory_order_release);
+    wake_writer(s);
+    if (s.writer.joinable()) s.writer.join();
+}
+
+void start_writer() {
+    state().writer = std::thread(writer_loop);
+    state().started.store(true, std::memory_order_release);
+    std::atexit(stop_writer);
+}
+
+bool admit(State& s, Level level, std::int64_t ts_ns) {
+    const std::uint32_t limit = s.rate_limit.load(std::memory_order_relaxed);
+    if (limit == 0 || level >= Level::Error) return true;
+
+    const std::int64_t second = ts_ns / 1000000000;
+    std::int64_t window = s.rate_window.load(std::memory_order_relaxed);
+    if (window != second && s.rate_window.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+        s.rate_count.store(0, std::memory_order_relaxed);
+    }
+    return s.rate_count.fetch_add(1, std::memory_order_relaxed) < limit;
+}
+
+} // namespace
+
+void set_level(Level level) noexcept {
+    detail::g_level.store(level, std::memory_order_relaxed);
+}
+
+void set_rate_limit(std::uint32_t per_second) noexcept {
+    state().rate_limit.store(per_second, std::memory_order_relaxed);
+}
+
+void set_sink(std::FILE* sink) noexcept {
+    flush();
+    state().sink.store(sink ? sink : stdout, std::memory_order_release);
+}
+
+void write(Level level, const char* fmt, ...) noexcept {
+    State& s = state();
+    try {
+        std::call_once(g_started, start_writer);
+    } catch (...) {
+        return;
+    }
+
+    const std::int64_t ts = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (!admit(s, level, ts)) {
+        s.dropped_rate.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::va_list args;
+    va_start(args, fmt);
+    const bool queued = s.queue.try_push([&](Record& r) {
+        r.ts_ns = ts;
+        r.level = level;
+        const int n = std::vsnprintf(r.text, sizeof(r.text), fmt, args);
+        r.len = static_cast<std::uint16_t>(n < 0 ? 0 : std::min<std::size_t>(static_cast<std::size_t>(n), sizeof(r.text) - 1));
+    });
+    va_end(args);
+
+    if (!queued) {
+        s.dropped_full.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (s.sleeping.load(std::memory_order_seq_cst)) wake_writer(s);
+}
+
+void flush() {
+    State& s = state();
+    if (!s.started.load(std::memory_order_acquire)) return;
+    const std::uint64_t target = s.queue.claimed();
+    while (s.written.load(std::memory_order_acquire) < target) {
+        wake_writer(s);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+Stats stats() noexcept {
+    State& s = state();
+    Stats out;
+    out.written = s.written.load(std::memory_order_relaxed);
+    out.dropped_full = s.dropped_full.load(std::memory_order_relaxed);
+    out.dropped_rate = s.dropped_rate.load(std::memory_order_relaxed);
+    return out;
+}
+
+} // namespace log
+} // namespace printpipe
@@ -0,0 +1,213 @@
+#include "printpipe/metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "printpipe/event_bus.hpp"
+
+namespace printpipe {
+
+namespace {
+
+// Bucket bounds are short by construction; sample values keep full precision.
+void append_number(std::string& out, double v, bool short_form = false) {
+    char buf[32];
+    const int n = std::snprintf(buf, sizeof(buf), short_form ? "%.9g" : "%.17g", v);
+    out.append(buf, static_cast<std::size_t>(n));
+}
+
+void append_sample(std::string& out, std::string_view name, std::string_view labels, double v) {
+    out.append(name);
+    if (!labels.empty()) {
+        out.push_back('{');
+        out.append(labels);
+        out.push_back('}');
+    }
+    out.push_back(' ');
+    append_number(out, v);
+    out.push_back('\n');
+}
+
+std::string join_labels(std::string_view labels, std::string_view extra) {
+    std::string out(labels);
+    if (!out.empty()) out.push_back(',');
+    out.append(extra);
+    return out;
+}
+
+const char* type_name(MetricsRegistry::Type t) {
+    switch (t) {
+        case MetricsRegistry::Type::Counter:   return "counter";
+        case MetricsRegistry::Type::Gauge:     return "gauge";
+        case MetricsRegistry::Type::Histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+} // namespace
+
+// ---- Histogram ----
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds))
+    , counts_(std::make_unique<std::atomic<std::uint64_t>[]>(bounds_.size() + 1)) {
+    std::sort(bounds_.begin(), bounds_.end());
+}
+
+void Histogram::observe(double v) noexcept {
+    const auto it = std::lower_bound(bounds_.begin(), bounds_.end(), v);
+    counts_[static_cast<std::size_t>(it - bounds_.begin())].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(v, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot s;
+    s.bounds = bounds_;
+    s.cumulative.reserve(bounds_.size() + 1);
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i <= bounds_.size(); ++i) {
+        total += counts_[i].load(std::memory_order_relaxed);
+        s.cumulative.push_back(total);
+    }
+    s.sum = sum_.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::vector<double> Histogram::latency_buckets() {
+    std::vector<double> b;
+    for (double v = 100e-6; v < 30.0; v *= 2) b.push_back(v);
+    return b;
+}
+
+// ---- MetricsRegistry ----
+
+MetricsRegistry::Series& MetricsRegistry::series(std::string_view name, std::string_view help, Type type,
+                                                 std::string labels) {
+    auto fam = std::find_if(families_.begin(), families_.end(), [&](const Family& f) { return f.name == name; });
+    if (fam == families_.end()) {
+        families_.push_back(Family{std::string(name), std::string(help), type, {}});
+        fam = families_.end() - 1;
+    }
+    for (auto& s : fam->series) {
+        if (s.labels == labels) return s;
+    }
+    fam->series.push_back(Series{std::move(labels), nullptr, nullptr, nullptr, nullptr});
+    return fam->series.back();
+}
+
+Counter& MetricsRegistry::counter(std::string_view name, std::string_view help, std::string labels) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& s = series(name, help, Type::Counter, std::move(labels));
+    if (!s.counter) s.counter = std::make_unique<Counter>();
+    return *s.counter;
+}
+
+Gauge& MetricsRegistry::gauge(std::string_view name, std::string_view help, std::string labels) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& s = series(name, help, Type::Gauge, std::move(labels));
+    if (!s.gauge) s.gauge = std::make_unique<Gauge>();
+    return *s.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(std::string_view name, std::string_view help, std::string labels,
+                                      std::vector<double> bounds) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& s = series(name, help, Type::Histogram, std::move(labels));
+    if (!s.histogram) s.histogram = std::make_unique<Histogram>(std::move(bounds));
+    return *s.histogram;
+}
+
+void MetricsRegistry::sampled(std::string_view name, std::string_view help, Type type, std::string labels,
+                              std::function<double()> read) {
+    std::lock_guard<std::mutex> lk(mu_);
+    series(name, help, type, std::move(labels)).read = std::move(read);
+}
+
+std::string MetricsRegistry::render() const {
+    std::string out;
+    out.reserve(4096);
+
+    std::lock_guard<std::mutex> lk(mu_);
+    for (const auto& f : families_) {
+        out += "# HELP " + f.name + " " + f.help + "\n";
+        out += "# TYPE " + f.name + " " + type_name(f.type) + "\n";
+
+        for (const auto& s : f.series) {
+            if (s.histogram) {
+                const auto snap = s.histogram->snapshot();
+                std::string le;
+                for (std::size_t i = 0; i < snap.bounds.size(); ++i) {
+                    le = "le=\"";
+                    append_number(le, snap.bounds[i], true);
+                    le += "\"";
+                    append_sample(out, f.name + "_bucket", join_labels(s.labels, le),
+                                  static_cast<double>(snap.cumulative[i]));
+                }
+                append_sample(out, f.name + "_bucket", join_labels(s.labels, "le=\"+Inf\""),
+                              static_cast<double>(snap.cumulative.back()));
+                append_sample(out, f.name + "_sum", s.labels, snap.sum);
+                append_sample(out, f.name + "_count", s.labels, static_cast<double>(snap.cumulative.back()));
+            } else if (s.counter) {
+                append_sample(out, f.name, s.labels, static_cast<double>(s.counter->value()));
+            } else if (s.gauge) {
+                append_sample(out, f.name, s.labels, static_cast<double>(s.gauge->value()));
+            } else if (s.read) {
+                append_sample(out, f.name, s.labels, s.read());
+            }
+        }
+    }
+    return out;
+}
+
+// ---- JobMetrics ----
+
+JobMetrics::JobMetrics(std::shared_ptr<MetricsRegistry> metrics)
+    : metrics_(std::move(metrics)) {
+    for (std::size_t i = 0; i < kStates; ++i) {
+        const auto s = static_cast<JobState>(i);
+        if (Job::is_terminal(s)) continue;
+        stage_[i] = &metrics_->histogram("printpipe_job_stage_seconds",
+                                         "Time jobs spend in each state before moving on",
+                                         std::string("stage=\"") + job_state_to_string(s) + "\"");
+    }
+}
+
+std::shared_ptr<JobMetrics> JobMetrics::attach(std::shared_ptr<MetricsRegistry> metrics, EventBus& bus,
+                                               std::function<std::uint64_t()> created_total) {
+    auto self = std::make_shared<JobMetrics>(metrics);
+
+    std::weak_ptr<JobMetrics> weak = self;
+    for (std::size_t i = 0; i < kStates; ++i) {
+        const auto s = static_cast<JobState>(i);
+        metrics->sampled("printpipe_jobs", "Jobs by state (terminal states count all finished jobs)",
+                         MetricsRegistry::Type::Gauge, std::string("state=\"") + job_state_to_string(s) + "\"",
+                         [weak, s, created_total] {
+                             auto m = weak.lock();
+                             return m ? static_cast<double>(m->in_state(s, created_total ? created_total() : 0)) : 0.0;
+                         });
+    }
+
+    bus.subscribe([self](const JobEvent& ev) { self->on_event(ev); });
+    return self;
+}
+
+void JobMetrics::on_event(const JobEvent& ev) noexcept {
+    if (ev.kind != EventKind::StateChanged) return;
+    const auto from = static_cast<std::size_t>(ev.from);
+    const auto to = static_cast<std::size_t>(ev.to);
+    if (from >= kStates || to >= kStates) return;
+
+    left_[from].fetch_add(1, std::memory_order_relaxed);
+    entered_[to].fetch_add(1, std::memory_order_relaxed);
+    if (stage_[from]) stage_[from]->observe(ev.dwell);
+}
+
+std::int64_t JobMetrics::in_state(JobState s, std::uint64_t created_total) const noexcept {
+    const auto i = static_cast<std::size_t>(s);
+    if (i >= kStates) return 0;
+    // Creation publishes no event, so Created's inflow comes from the owner
+    const std::uint64_t in = s == JobState::Created ? created_total : entered_[i].load(std::memory_order_relaxed);
+    return static_cast<std::int64_t>(in) - static_cast<std::int64_t>(left_[i].load(std::memory_order_relaxed));
+}
+
+} // namespace printpipe
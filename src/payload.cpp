@@ -0,0 +1,275 @@
+#include "printpipe/payload.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+namespace printpipe {
+
+namespace {
+
+bool write_all(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+        const ssize_t r = ::write(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+} // namespace
+
+// ---- PayloadView ----
+
+PayloadView::~PayloadView() {
+    if (map_) ::munmap(map_, map_len_);
+}
+
+PayloadView::PayloadView(PayloadView&& other) noexcept
+    : data_(other.data_)
+    , map_(other.map_)
+    , map_len_(other.map_len_)
+    , valid_(other.valid_) {
+    other.map_ = nullptr;
+    other.map_len_ = 0;
+    other.data_ = {};
+    other.valid_ = false;
+}
+
+PayloadView& PayloadView::operator=(PayloadView&& other) noexcept {
+    if (this != &other) {
+        if (map_) ::munmap(map_, map_len_);
+        data_ = other.data_;
+        map_ = other.map_;
+        map_len_ = other.map_len_;
+        valid_ = other.valid_;
+        other.map_ = nullptr;
+        other.map_len_ = 0;
+        other.data_ = {};
+        other.valid_ = false;
+    }
+    return *this;
+}
+
+// ---- Payload ----
+
+Payload::~Payload() {
+    if (map_) {
+        ::munmap(map_, size_);
+    } else if (spilled()) {
+        std::error_code ec;
+        std::filesystem::remove(file_, ec);
+    } else if (resident_) {
+        resident_->fetch_sub(data_.size(), std::memory_order_relaxed);
+    }
+}
+
+std::shared_ptr<const Payload> Payload::from_string(std::string data) {
+    std::shared_ptr<Payload> p(new Payload());
+    p->size_ = data.size();
+    p->data_ = std::move(data);
+    return p;
+}
+
+bool Payload::sealed_fd(int fd) {
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return false;
+#ifdef F_GET_SEALS
+    const int seals = ::fcntl(fd, F_GET_SEALS);
+    constexpr int kRequired = F_SEAL_SHRINK | F_SEAL_WRITE;
+    return seals >= 0 && (seals & kRequired) == kRequired;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<const Payload> Payload::from_fd(int fd) {
+    if (!sealed_fd(fd)) return nullptr;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < 0) return nullptr;
+
+    std::shared_ptr<Payload> p(new Payload());
+    p->size_ = static_cast<std::size_t>(st.st_size);
+    if (p->size_ == 0) return p;
+
+    void* addr = ::mmap(nullptr, p->size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) return nullptr;
+    p->map_ = addr;
+    return p;
+}
+
+PayloadView Payload::view() const {
+    PayloadView v;
+    if (map_) {
+        v.data_ = std::string_view(static_cast<const char*>(map_), size_);
+        v.valid_ = true;
+        return v;
+    }
+    if (!spilled()) {
+        v.data_ = data_;
+        v.valid_ = true;
+        return v;
+    }
+    if (size_ == 0) {
+        v.valid_ = true;
+        return v;
+    }
+
+    int fd = ::open(file_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return v;
+    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) return v;
+
+    (void)::madvise(addr, size_, MADV_SEQUENTIAL);
+    v.map_ = addr;
+    v.map_len_ = size_;
+    v.data_ = std::string_view(static_cast<const char*>(addr), size_);
+    v.valid_ = true;
+    return v;
+}
+
+// ---- PayloadStore ----
+
+PayloadStore::PayloadStore(PayloadStoreConfig cfg)
+    : cfg_(std::move(cfg))
+    , resident_(std::make_shared<std::atomic<std::size_t>>(0)) {}
+
+bool PayloadStore::try_reserve(std::size_t n) noexcept {
+    std::size_t cur = resident_->load(std::memory_order_relaxed);
+    do {
+        if (cur + n > cfg_.max_resident_bytes) return false;
+    } while (!resident_->compare_exchange_weak(cur, cur + n, std::memory_order_relaxed));
+    return true;
+}
+
+std::filesystem::path PayloadStore::next_spool_path() {
+    return cfg_.spool_dir / ("payload-" + std::to_string(::getpid()) + "-"
+                             + std::to_string(seq_.fetch_add(1)) + ".bin");
+}
+
+// The default lives in the shared temp directory, so a directory that is
+// already there may have been planted by another user.
+bool PayloadStore::ensure_spool_dir() const {
+    const auto& dir = cfg_.spool_dir;
+    std::error_code ec;
+    if (dir.has_parent_path()) std::filesystem::create_directories(dir.parent_path(), ec);
+    if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) return false;
+
+    struct stat st{};
+    if (::lstat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != ::geteuid()) return false;
+    return (st.st_mode & 077) == 0 || ::chmod(dir.c_str(), 0700) == 0;
+}
+
+int PayloadStore::create_spool_file(std::filesystem::path& path) {
+    if (!ensure_spool_dir()) return -1;
+    // Names are predictable; O_EXCL makes sure the file is a new one of ours
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        path = next_spool_path();
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd >= 0 || errno != EEXIST) return fd;
+    }
+    return -1;
+}
+
+PayloadPtr PayloadStore::store(std::string data) {
+    std::shared_ptr<Payload> p(new Payload());
+    p->size_ = data.size();
+
+    if (data.size() < cfg_.spill_threshold && try_reserve(data.size())) {
+        p->data_ = std::move(data);
+        p->resident_ = resident_;
+        return p;
+    }
+
+    std::filesystem::path path;
+    const int fd = create_spool_file(path);
+    if (fd < 0) throw std::runtime_error("failed to create spool file in " + cfg_.spool_dir.string());
+    const bool written = write_all(fd, data.data(), data.size());
+    if (::close(fd) != 0 || !written) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        throw std::runtime_error("failed to spool payload to " + path.string());
+    }
+
+    p->file_ = std::move(path);
+    return p;
+}
+
+// ---- PayloadWriter ----
+
+PayloadWriter::PayloadWriter(PayloadStore& store)
+    : store_(&store) {}
+
+PayloadWriter::~PayloadWriter() {
+    if (fd_ >= 0) ::close(fd_);
+    // Abandoned before finish(): drop the partial spool file
+    if (!file_.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(file_, ec);
+    }
+}
+
+bool PayloadWriter::spill_buffer() {
+    fd_ = store_->create_spool_file(file_);
+    if (fd_ < 0) {
+        file_.clear();
+        return false;
+    }
+    const bool ok = write_all(fd_, buf_.data(), buf_.size());
+    std::string().swap(buf_);
+    return ok;
+}
+
+bool PayloadWriter::append(const char* data, std::size_t len) {
+    if (failed_) return false;
+    size_ += len;
+
+    if (file_.empty()) {
+        if (size_ < store_->cfg_.spill_threshold) {
+            buf_.append(data, len);
+            return true;
+        }
+        if (!spill_buffer()) {
+            failed_ = true;
+            return false;
+        }
+    }
+
+    if (!write_all(fd_, data, len)) failed_ = true;
+    return !failed_;
+}
+
+PayloadPtr PayloadWriter::finish() {
+    if (failed_) return nullptr;
+
+    // Small enough to keep, but only if the resident budget allows it
+    if (file_.empty() && !store_->try_reserve(buf_.size())) {
+        if (!spill_buffer()) return nullptr;
+    }
+
+    std::shared_ptr<Payload> p(new Payload());
+    p->size_ = size_;
+
+    if (file_.empty()) {
+        p->data_ = std::move(buf_);
+        p->resident_ = store_->resident_;
+        return p;
+    }
+
+    const bool closed = ::close(fd_) == 0;
+    fd_ = -1;
+    if (!closed) return nullptr;    // destructor removes the file
+    p->file_ = std::move(file_);
+    file_.clear();
+    return p;
+}
+
+} // namespace printpipe
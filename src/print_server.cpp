@@ -1,21 +1,32 @@
 #include "printpipe/print_server.hpp"
+#include "printpipe/backend_pool.hpp"
 #include "printpipe/file_backend.hpp"
+#include "printpipe/json_writer.hpp"
+#include "printpipe/log.hpp"
+#include "printpipe/metrics.hpp"
+#include "printpipe/static_assets.hpp"
+#include "printpipe/trace.hpp"
 
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
 #include <fstream>
 #include <csignal>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
 
 using json = nlohmann::json;
 
 namespace printpipe {
 
-// Global pointer for signal handler
-static std::atomic<httplib::Server*> g_server{nullptr};
+// Listeners the signal handler stops
+static std::atomic<std::vector<std::unique_ptr<httplib::Server>>*> g_servers{nullptr};
 static std::atomic<bool> g_shutdown_requested{false};
 
 static void signal_handler(int signal) {
@@ -25,39 +36,116 @@ static void signal_handler(int signal) {
     }
     
     std::cout << "\n[Main] Caught signal " << signal << ", shutting down...\n";
-    auto* server = g_server.load();
-    if (server) {
-        server->stop();
+    auto* servers = g_servers.load();
+    if (servers) {
+        for (auto& server : *servers) server->stop();
     }
 }
 
-static const char* job_state_to_string(JobState s) {
-    switch (s) {
-        case JobState::Created:   return "created";
-        case JobState::Queued:    return "queued";
-        case JobState::Scheduled: return "scheduled";
-        case JobState::Spooling:  return "spooling";
-        case JobState::Printing:  return "printing";
-        case JobState::Completed: return "completed";
-        case JobState::Canceled:  return "canceled";
-        case JobState::Failed:    return "failed";
+// Hot read endpoints answer compact JSON unless asked for ?pretty=1
+static bool wants_pretty(const httplib::Request& req) {
+    return req.has_param("pretty") && req.get_param_value("pretty") != "0";
+}
+
+// Answers from the in-memory copy: 304 when the client's ETag is current,
+// otherwise the gzip or identity body, streamed straight from the cache.
+static void serve_asset(const httplib::Request& req, httplib::Response& res, StaticAssetPtr asset) {
+    const bool gzip = !asset->gzip.empty() && accepts_gzip(req.get_header_value("Accept-Encoding"));
+    const std::string& etag = gzip ? asset->gzip_etag : asset->etag;
+
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("Vary", "Accept-Encoding");
+    if (etag_matches(req.get_header_value("If-None-Match"), etag)) {
+        res.status = 304;
+        return;
     }
-    return "unknown";
+    if (gzip) res.set_header("Content-Encoding", "gzip");
+
+    const std::string* body = gzip ? &asset->gzip : &asset->body;
+    res.set_content_provider(body->size(), asset->content_type,
+                             [asset = std::move(asset), body](std::size_t offset, std::size_t length,
+                                                               httplib::DataSink& sink) {
+                                 return sink.write(body->data() + offset, length);
+                             });
 }
 
-PrintServer::PrintServer(int port, std::filesystem::path output_dir)
+// Registers routes on an httplib server, recording each handler's latency
+// in a histogram labeled with its method and route pattern, and as a trace
+// span named after the route.
+class TimedRoutes {
+public:
+    TimedRoutes(httplib::Server& server, MetricsRegistry& metrics)
+        : server_(server), metrics_(metrics) {}
+
+    void Get(const std::string& pattern, httplib::Server::Handler handler) {
+        server_.Get(pattern, timed("GET", pattern, std::move(handler)));
+    }
+    void Post(const std::string& pattern, httplib::Server::Handler handler) {
+        server_.Post(pattern, timed("POST", pattern, std::move(handler)));
+    }
+    void Post(const std::string& pattern, httplib::Server::HandlerWithContentReader handler) {
+        server_.Post(pattern, timed("POST", pattern, std::move(handler)));
+    }
+    void Put(const std::string& pattern, httplib::Server::HandlerWithContentReader handler) {
+        server_.Put(pattern, timed("PUT", pattern, std::move(handler)));
+    }
+
+private:
+    template <typename Handler>
+    Handler timed(const char* method, const std::string& pattern, Handler handler) {
+        Histogram& h = metrics_.histogram("printpipe_http_request_duration_seconds", "HTTP handler latency",
+                                          std::string("method=\"") + method + "\",route=\"" + pattern + "\"");
+        const char* span_name = trace::intern(std::string(method) + " " + pattern);
+        return [&h, span_name, handler = std::move(handler)](auto&... args) {
+            trace::Scope span(span_name);
+            const auto start = std::chrono::steady_clock::now();
+            handler(args...);
+            h.observe(std::chrono::steady_clock::now() - start);
+        };
+    }
+
+    httplib::Server& server_;
+    MetricsRegistry& metrics_;
+};
+
+PrintServer::PrintServer(int port, std::filesystem::path output_dir, HttpFrontendConfig http,
+                         PrintDeviceConfig devices)
     : port_(port)
     , output_dir_(std::move(output_dir))
+    , http_(std::move(http))
     , event_bus_(std::make_shared<EventBus>())
-    , scheduler_(std::make_shared<Scheduler>())
+    , metrics_(std::make_shared<MetricsRegistry>())
+    , scheduler_(std::make_shared<Scheduler>(
+          devices.workers ? devices.workers : std::max<std::size_t>(devices.backends.size(), 1)))
+    , registry_(output_dir_, event_bus_)
+    , assets_(std::make_unique<StaticAssets>("web"))
 {
-    // Set up scheduler with file backend
-    auto backend = std::make_shared<FileBackend>(output_dir_);
-    scheduler_->set_backend(backend);
+    registry_.set_payload_store(std::make_shared<PayloadStore>());
+    // Age limits must hold between requests too
+    registry_.sweep_every(std::chrono::seconds(1));
+    assets_->reload();
+    assets_->watch();
+    ipp_printer_ = std::make_unique<IppPrinter>(registry_, *scheduler_,
+                                                "ipp://localhost:" + std::to_string(port_) + "/ipp/print");
+    register_metrics();
+
+    // Set up scheduler with file backend, or a pool over the given devices
+    if (devices.backends.empty()) {
+        scheduler_->set_backend(std::make_shared<FileBackend>(output_dir_));
+    } else {
+        auto pool = std::make_shared<BackendPool>();
+        for (auto& backend : devices.backends) pool->add(std::move(backend));
+        PRINTPIPE_LOG_INFO("[PrintServer] Printing to %zu device(s) with %zu scheduler worker(s)",
+                           pool->size(), scheduler_->worker_count());
+        scheduler_->set_backend(std::move(pool));
+    }
     scheduler_->start();
 }
 
 PrintServer::~PrintServer() {
+    // Local submitters feed the scheduler, so they go first
+    if (local_server_) local_server_->stop();
     scheduler_->stop();
     stop();
 }
@@ -66,95 +154,108 @@ void PrintServer::set_spooler(SpoolerPtr spooler) {
     scheduler_->set_spooler(std::move(spooler));
 }
 
-std::string PrintServer::create_job(const std::string& name, const std::string& payload) {
-    std::lock_guard<std::mutex> lock(jobs_mutex_);
-    
-    uint64_t id = job_counter_.fetch_add(1);
-    std::ostringstream oss;
-    oss << "job-" << std::setfill('0') << std::setw(6) << id;
-    std::string job_id = oss.str();
-    
-    auto job = std::make_shared<Job>(name);
-    job->set_event_bus(event_bus_);
-    job->set_payload(payload);
-    
-    auto output_file = output_dir_ / (name + ".txt");
-    jobs_[job_id] = JobEntry{job, output_file};
-    
-    std::cout << "[PrintServer] Created job: " << job_id 
-              << " (name: " << name << ", output: " << output_file << ")\n";
+void PrintServer::set_payload_store(std::shared_ptr<PayloadStore> store) {
+    registry_.set_payload_store(std::move(store));
+}
+
+void PrintServer::set_retention_policy(RetentionPolicy policy) {
+    registry_.set_retention_policy(policy);
+}
+
+void PrintServer::register_metrics() {
+    using Type = MetricsRegistry::Type;
+    job_metrics_ = JobMetrics::attach(metrics_, *event_bus_, [this] { return registry_.created_total(); });
     
-    return job_id;
+    // Scheduler counters live in the scheduler; sample them at scrape time
+    const auto sched = scheduler_;
+    const auto stat = [sched](auto field) {
+        return [sched, field] { return static_cast<double>(sched->stats().*field); };
+    };
+    metrics_->sampled("printpipe_queue_depth", "Jobs waiting for a worker", Type::Gauge, {},
+                      stat(&SchedulerStats::queued));
+    metrics_->sampled("printpipe_retries_pending", "Jobs waiting out a retry backoff", Type::Gauge, {},
+                      stat(&SchedulerStats::retries_pending));
+    metrics_->sampled("printpipe_retries_total", "Retries scheduled", Type::Counter, {},
+                      stat(&SchedulerStats::retries_scheduled));
+    metrics_->sampled("printpipe_spooled_bytes_total", "Bytes produced by the spooler", Type::Counter, {},
+                      stat(&SchedulerStats::spooled_bytes));
+    metrics_->sampled("printpipe_printed_bytes_total", "Payload bytes accepted by the backend", Type::Counter, {},
+                      stat(&SchedulerStats::printed_bytes));
+    metrics_->sampled("printpipe_batches_total", "Coalesced backend operations", Type::Counter, {},
+                      stat(&SchedulerStats::batches));
+    metrics_->sampled("printpipe_cancel_releases_total", "Canceled jobs released by workers", Type::Counter, {},
+                      stat(&SchedulerStats::cancel_releases));
+    // The observer keeps the registry, and so the histogram, alive
+    Histogram& release = metrics_->histogram("printpipe_cancel_release_seconds",
+                                             "Time from cancel() until a worker released the job");
+    scheduler_->set_cancel_release_observer([metrics = metrics_, &release](std::chrono::nanoseconds d) {
+        release.observe(d);
+    });
+}
+
+bool PrintServer::enable_local_socket(std::filesystem::path socket_path) {
+    if (local_server_) local_server_->stop();
+    local_server_ = std::make_unique<LocalSubmitServer>(std::move(socket_path), registry_, *scheduler_);
+    if (!local_server_->start()) {
+        local_server_.reset();
+        return false;
+    }
+    PRINTPIPE_LOG_INFO("[PrintServer] Local submissions on %s", local_server_->socket_path().c_str());
+    return true;
+}
+
+std::string PrintServer::create_job(const std::string& name, std::string payload) {
+    JobRecord rec = registry_.create(name, std::move(payload));
+
+    PRINTPIPE_LOG_INFO("[PrintServer] Created job: %s (name: %s, output: %s)",
+                       rec.id.c_str(), name.c_str(), rec.output_file.c_str());
+
+    // Retire finished jobs incrementally as new ones arrive
+    registry_.sweep();
+
+    return rec.id;
 }
 
 bool PrintServer::submit_job(const std::string& job_id) {
-    std::shared_ptr<Job> job;
-    
-    {
-        std::lock_guard<std::mutex> lock(jobs_mutex_);
-        auto it = jobs_.find(job_id);
-        if (it == jobs_.end()) {
-            return false;
-        }
-        job = it->second.job;
+    auto rec = registry_.find(job_id);
+    if (!rec) {
+        return false;
     }
     
     // Submit to scheduler for async processing
-    bool submitted = scheduler_->submit(job);
+    bool submitted = scheduler_->submit(rec->job);
     
     if (submitted) {
-        std::cout << "[PrintServer] Submitted job " << job_id << " to scheduler\n";
+        PRINTPIPE_LOG_INFO("[PrintServer] Submitted job %s to scheduler", job_id.c_str());
     } else {
-        std::cout << "[PrintServer] Failed to submit job " << job_id << "\n";
+        PRINTPIPE_LOG_WARN("[PrintServer] Failed to submit job %s", job_id.c_str());
     }
     
     return submitted;
 }
 
-std::string PrintServer::get_job_status(const std::string& job_id) {
-    std::lock_guard<std::mutex> lock(jobs_mutex_);
-    
-    auto it = jobs_.find(job_id);
-    if (it == jobs_.end()) {
-        return "{}";
-    }
-    
-    json j;
-    j["job_id"] = job_id;
-    j["name"] = it->second.job->name();
-    j["state"] = job_state_to_string(it->second.job->state());
-    j["output_file"] = it->second.output_file.string();
-    j["file_exists"] = std::filesystem::exists(it->second.output_file);
-    
-    return j.dump(2);
-}
-
-std::vector<std::string> PrintServer::list_jobs() {
-    std::lock_guard<std::mutex> lock(jobs_mutex_);
-    
-    std::vector<std::string> job_ids;
-    job_ids.reserve(jobs_.size());
-    
-    for (const auto& [id, _] : jobs_) {
-        job_ids.push_back(id);
-    }
-    
-    return job_ids;
+// Keys in alphabetical order, as the nlohmann DOM used to emit them
+void PrintServer::write_job_status(JsonWriter& w, const JobRecord& rec) {
+    w.begin_object()
+        .field("file_exists", std::filesystem::exists(rec.output_file))
+        .field("job_id", rec.id)
+        .field("name", rec.job->name())
+        .field("output_file", rec.output_file.string())
+        .field("state", job_state_to_string(rec.job->state()))
+        .end_object();
 }
 
 std::string PrintServer::get_output_file(const std::string& job_id) {
-    std::lock_guard<std::mutex> lock(jobs_mutex_);
-    
-    auto it = jobs_.find(job_id);
-    if (it == jobs_.end()) {
+    auto rec = registry_.find(job_id);
+    if (!rec) {
         return {};
     }
     
-    if (!std::filesystem::exists(it->second.output_file)) {
+    if (!std::filesystem::exists(rec->output_file)) {
         return {};
     }
     
-    std::ifstream file(it->second.output_file);
+    std::ifstream file(rec->output_file);
     if (!file) {
         return {};
     }
@@ -163,16 +264,39 @@ std::string PrintServer::get_output_file(const std::string& job_id) {
                       std::istreambuf_iterator<char>());
 }
 
-void PrintServer::start() {
-    httplib::Server server;
+void PrintServer::configure_listener(httplib::Server& server) const {
+    const std::size_t threads = http_.worker_threads;
+    const std::size_t max_queued = http_.max_queued_requests;
+    if (threads || max_queued) {
+        server.new_task_queue = [threads, max_queued] {
+            return new httplib::ThreadPool(threads ? threads : CPPHTTPLIB_THREAD_POOL_COUNT, max_queued);
+        };
+    }
+    server.set_keep_alive_max_count(http_.keep_alive_max_count);
+    server.set_keep_alive_timeout(http_.keep_alive_timeout.count());
+    server.set_read_timeout(http_.read_timeout.count());
+    server.set_write_timeout(http_.write_timeout.count());
+
+    // Only several listeners need SO_REUSEPORT; with one, a second server
+    // on the same port should still fail to bind
+    server.set_socket_options([reuse_port = http_.listeners > 1](httplib::socket_t sock) {
+        int yes = 1;
+        ::setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+#ifdef SO_REUSEPORT
+        if (reuse_port) ::setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes));
+#else
+        (void)reuse_port;
+#endif
+    });
+}
+
+void PrintServer::register_routes(httplib::Server& server) {
+    TimedRoutes routes(server, *metrics_);
     
     // Serve web UI
-    server.Get("/", [](const httplib::Request&, httplib::Response& res) {
-        std::ifstream file("web/index.html");
-        if (file) {
-            std::string html((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-            res.set_content(html, "text/html");
+    routes.Get("/", [this](const httplib::Request& req, httplib::Response& res) {
+        if (auto index = assets_->find("/")) {
+            serve_asset(req, res, std::move(index));
         } else {
             // Fallback to API info
             json j;
@@ -182,24 +306,29 @@ void PrintServer::start() {
             j["web_ui"] = "Place index.html in web/ directory to enable web interface";
             j["endpoints"] = {
                 {"POST /api/jobs", "Create a new print job"},
+                {"PUT /api/jobs/:id/payload", "Upload the raw job document (streamed)"},
                 {"POST /api/jobs/:id/submit", "Submit a job for async processing"},
+                {"POST /api/jobs/:id/cancel", "Cancel a job, aborting in-flight work"},
                 {"GET /api/jobs/:id", "Get job status"},
                 {"GET /api/jobs/:id/output", "Download job output file"},
                 {"GET /api/jobs", "List all jobs"},
-                {"GET /api/events", "Get all events"}
+                {"GET /api/events", "Get all events"},
+                {"GET /api/trace", "Trace spans as Chrome trace-event JSON (?job=ID)"},
+                {"GET /metrics", "Prometheus metrics"},
+                {"POST /ipp/print", "IPP/1.1 Print-Job, Validate-Job, Cancel-Job, Get-Job-Attributes"}
             };
             res.set_content(j.dump(2), "application/json");
         }
     });
     
     // Create a new job
-    server.Post("/api/jobs", [this](const httplib::Request& req, httplib::Response& res) {
+    routes.Post("/api/jobs", [this](const httplib::Request& req, httplib::Response& res) {
         try {
             auto body = json::parse(req.body);
             std::string name = body.value("name", "untitled");
             std::string payload = body.value("payload", "Default print content");
             
-            std::string job_id = create_job(name, payload);
+            std::string job_id = create_job(name, std::move(payload));
             
             json response;
             response["job_id"] = job_id;
@@ -216,8 +345,97 @@ void PrintServer::start() {
         }
     });
     
+    // Upload the raw document for a job, streamed straight into payload
+    // storage. Accepts application/octet-stream (or any raw body) and
+    // multipart/form-data, where the first part is taken as the document.
+    routes.Put("/api/jobs/:id/payload", [this](const httplib::Request& req, httplib::Response& res,
+                                              const httplib::ContentReader& content_reader) {
+        std::string job_id = req.path_params.at("id");
+        auto rec = registry_.find(job_id);
+        
+        if (!rec) {
+            json error;
+            error["error"] = "Job not found";
+            res.status = 404;
+            res.set_content(error.dump(2), "application/json");
+            return;
+        }
+        if (rec->job->state() != JobState::Created) {
+            json error;
+            error["error"] = "Payload can only be uploaded before the job is submitted";
+            res.status = 409;
+            res.set_content(error.dump(2), "application/json");
+            return;
+        }
+        
+        std::optional<PayloadWriter> writer;
+        writer.emplace(*registry_.payload_store());
+        
+        bool received;
+        if (req.is_multipart_form_data()) {
+            int part = 0;
+            received = content_reader(
+                [&](const httplib::MultipartFormData&) { ++part; return true; },
+                [&](const char* data, size_t len) { return part != 1 || writer->append(data, len); });
+        } else {
+            received = content_reader([&](const char* data, size_t len) { return writer->append(data, len); });
+        }
+        if (!received) {
+            // Disconnect, short body or a failed write: keep nothing of it
+            writer.reset();
+            json error;
+            error["error"] = "Incomplete payload upload";
+            res.status = 400;
+            res.set_content(error.dump(2), "application/json");
+            return;
+        }
+        
+        auto payload = writer->finish();
+        if (!payload) {
+            json error;
+            error["error"] = "Failed to store payload";
+            res.status = 500;
+            res.set_content(error.dump(2), "application/json");
+            return;
+        }
+        
+        const bool spilled = payload->spilled();
+        const auto bytes = payload->size();
+        // The upload may have taken a while; a submit in the meantime wins
+        if (!rec->job->set_payload_if_created(std::move(payload))) {
+            json error;
+            error["error"] = "Job was submitted while the payload was uploading";
+            res.status = 409;
+            res.set_content(error.dump(2), "application/json");
+            return;
+        }
+        
+        json response;
+        response["job_id"] = job_id;
+        response["bytes"] = bytes;
+        response["spilled"] = spilled;
+        res.set_content(response.dump(2), "application/json");
+    });
+    
+    // Native IPP endpoint for standard clients. The attribute section is
+    // parsed in place and Print-Job documents stream into payload storage.
+    routes.Post("/ipp/print", [this](const httplib::Request& req, httplib::Response& res,
+                                     const httplib::ContentReader& content_reader) {
+        if (req.get_header_value("Content-Type").rfind("application/ipp", 0) != 0) {
+            res.status = 415;
+            return;
+        }
+        
+        IppPrinter::Exchange exchange(*ipp_printer_);
+        // A cut-off document must not be printed
+        if (!content_reader([&](const char* data, size_t len) { return exchange.write(data, len); })) {
+            exchange.abort();
+        }
+        res.set_content(exchange.finish(), "application/ipp");
+    });
+    
     // Submit a job for processing
-    server.Post("/api/jobs/:id/submit", [this](const httplib::Request& req, httplib::Response& res) {
+    routes.Post("/api/jobs/:id/submit", [this](const httplib::Request& req, httplib::Response& res) {
         std::string job_id = req.path_params.at("id");
         
         if (submit_job(job_id)) {
@@ -235,23 +453,49 @@ void PrintServer::start() {
         }
     });
     
+    // Cancel a job; in-flight spooling/printing is abandoned cooperatively
+    routes.Post("/api/jobs/:id/cancel", [this](const httplib::Request& req, httplib::Response& res) {
+        std::string job_id = req.path_params.at("id");
+        auto rec = registry_.find(job_id);
+        
+        if (!rec) {
+            json error;
+            error["error"] = "Job not found";
+            res.status = 404;
+            res.set_content(error.dump(2), "application/json");
+        } else if (rec->job->cancel()) {
+            json response;
+            response["job_id"] = job_id;
+            response["status"] = "canceled";
+            res.set_content(response.dump(2), "application/json");
+        } else {
+            json error;
+            error["error"] = "Job already finished";
+            res.status = 409;
+            res.set_content(error.dump(2), "application/json");
+        }
+    });
+    
     // Get job status
-    server.Get("/api/jobs/:id", [this](const httplib::Request& req, httplib::Response& res) {
+    routes.Get("/api/jobs/:id", [this](const httplib::Request& req, httplib::Response& res) {
         std::string job_id = req.path_params.at("id");
-        std::string status_json = get_job_status(job_id);
+        auto rec = registry_.find(job_id);
         
-        if (status_json == "{}") {
+        if (!rec) {
             json error;
             error["error"] = "Job not found";
             res.status = 404;
             res.set_content(error.dump(2), "application/json");
         } else {
-            res.set_content(status_json, "application/json");
+            std::string body;
+            JsonWriter w(body, wants_pretty(req));
+            write_job_status(w, *rec);
+            res.set_content(std::move(body), "application/json");
         }
     });
     
     // Download job output
-    server.Get("/api/jobs/:id/output", [this](const httplib::Request& req, httplib::Response& res) {
+    routes.Get("/api/jobs/:id/output", [this](const httplib::Request& req, httplib::Response& res) {
         std::string job_id = req.path_params.at("id");
         std::string output = get_output_file(job_id);
         
@@ -266,47 +510,136 @@ void PrintServer::start() {
     });
     
     // List all jobs
-    server.Get("/api/jobs", [this](const httplib::Request&, httplib::Response& res) {
-        auto job_ids = list_jobs();
+    routes.Get("/api/jobs", [this](const httplib::Request& req, httplib::Response& res) {
+        registry_.sweep();
+        const auto records = registry_.list();
         
-        json j = json::array();
-        for (const auto& job_id : job_ids) {
-            j.push_back(json::parse(get_job_status(job_id)));
+        std::string body;
+        body.reserve(records.size() * 160);
+        JsonWriter w(body, wants_pretty(req));
+        w.begin_array();
+        for (const auto& rec : records) {
+            write_job_status(w, rec);
         }
+        w.end_array();
         
-        res.set_content(j.dump(2), "application/json");
+        res.set_content(std::move(body), "application/json");
     });
     
     // Get all events
-    server.Get("/api/events", [this](const httplib::Request&, httplib::Response& res) {
-        auto events = event_bus_->snapshot();
+    routes.Get("/api/events", [this](const httplib::Request& req, httplib::Response& res) {
+        const auto events = event_bus_->snapshot();
         
-        json j = json::array();
+        std::string body;
+        body.reserve(events.size() * 180);
+        JsonWriter w(body, wants_pretty(req));
+        w.begin_array();
         for (const auto& event : events) {
-            json ev;
-            ev["kind"] = (event.kind == EventKind::StateChanged) ? "state_changed" : "rejected_transition";
-            ev["job_name"] = event.job_name;
-            ev["from"] = job_state_to_string(event.from);
-            ev["to"] = job_state_to_string(event.to);
-            ev["reason"] = event.reason;
-            j.push_back(ev);
+            // Monotonic clock, for replaying arrivals (see printpipe_sim)
+            const std::int64_t ts_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                event.ts.time_since_epoch()).count();
+            const std::int64_t dwell_us = std::chrono::duration_cast<std::chrono::microseconds>(event.dwell).count();
+            w.begin_object()
+                .field("dwell_us", dwell_us)
+                .field("from", job_state_to_string(event.from))
+                .field("job_name", event_bus_->job_name(event.job_id))
+                .field("kind", event.kind == EventKind::StateChanged ? "state_changed" : "rejected_transition")
+                .field("reason", reason_to_string(event.reason))
+                .field("to", job_state_to_string(event.to))
+                .field("ts_us", ts_us)
+                .end_object();
         }
+        w.end_array();
         
-        res.set_content(j.dump(2), "application/json");
+        res.set_content(std::move(body), "application/json");
+    });
+    
+    // Recorded spans as Chrome trace-event JSON, optionally for one job
+    // (?job=job-000001 or the numeric id)
+    routes.Get("/api/trace", [this](const httplib::Request& req, httplib::Response& res) {
+        std::optional<JobId> job;
+        if (req.has_param("job")) {
+            const std::string id = req.get_param_value("job");
+            if (auto rec = registry_.find(id)) {
+                job = rec->job->id();
+            } else {
+                try {
+                    job = static_cast<JobId>(std::stoul(id));
+                } catch (...) {
+                    json error;
+                    error["error"] = "Job not found";
+                    res.status = 404;
+                    res.set_content(error.dump(2), "application/json");
+                    return;
+                }
+            }
+        }
+        res.set_content(trace::to_chrome_json(trace::collect(job)), "application/json");
+    });
+    
+    // Prometheus scrape endpoint
+    routes.Get("/metrics", [this](const httplib::Request&, httplib::Response& res) {
+        res.set_content(metrics_->render(), "text/plain; version=0.0.4");
+    });
+
+    // Remaining GETs are web UI assets (scripts, styles, images); registered
+    // last so the API routes above take precedence
+    routes.Get(R"(/.+)", [this](const httplib::Request& req, httplib::Response& res) {
+        if (auto asset = assets_->find(req.path)) {
+            serve_asset(req, res, std::move(asset));
+        } else {
+            res.status = 404;
+        }
     });
     
-    std::cout << "[PrintServer] Starting HTTP server on port " << port_ << "...\n";
-    std::cout << "[PrintServer] Output directory: " << std::filesystem::absolute(output_dir_) << "\n";
-    std::cout << "[PrintServer] Access at http://localhost:" << port_ << "\n";
+}
+
+void PrintServer::start() {
+#ifdef SO_REUSEPORT
+    const std::size_t count = std::max<std::size_t>(http_.listeners, 1);
+#else
+    if (http_.listeners > 1) PRINTPIPE_LOG_WARN("[PrintServer] SO_REUSEPORT unavailable; using one listener");
+    const std::size_t count = 1;
+#endif
+
+    std::vector<std::unique_ptr<httplib::Server>> servers;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto server = std::make_unique<httplib::Server>();
+        configure_listener(*server);
+        register_routes(*server);
+        // Bind them all up front so a busy port fails before anything serves
+        if (!server->bind_to_port(http_.host, port_)) {
+            PRINTPIPE_LOG_ERROR("[PrintServer] Could not bind %s:%d", http_.host.c_str(), port_);
+            return;
+        }
+        servers.push_back(std::move(server));
+    }
+
+    PRINTPIPE_LOG_INFO("[PrintServer] Starting HTTP server on port %d...", port_);
+    PRINTPIPE_LOG_INFO("[PrintServer] %zu listener(s), %zu worker(s) each, keep-alive %zu requests/%llds",
+                       count, http_.worker_threads ? http_.worker_threads : std::size_t{CPPHTTPLIB_THREAD_POOL_COUNT},
+                       http_.keep_alive_max_count, static_cast<long long>(http_.keep_alive_timeout.count()));
+    PRINTPIPE_LOG_INFO("[PrintServer] Output directory: %s", std::filesystem::absolute(output_dir_).c_str());
+    PRINTPIPE_LOG_INFO("[PrintServer] Access at http://localhost:%d", port_);
     
     // Install signal handlers for graceful shutdown
-    g_server.store(&server);
+    g_servers.store(&servers);
     std::signal(SIGINT, signal_handler);   // Ctrl+C
     std::signal(SIGTERM, signal_handler);  // kill command
     
-    server.listen("0.0.0.0", port_);
+    std::vector<std::thread> accept_threads;
+    for (std::size_t i = 1; i < count; ++i) {
+        accept_threads.emplace_back([server = servers[i].get()] { server->listen_after_bind(); });
+        // stop() is a no-op on a listener that isn't running yet
+        servers[i]->wait_until_ready();
+    }
+    servers.front()->listen_after_bind();
+
+    // The first listener stopping (signal or error) takes the rest down
+    for (auto& server : servers) server->stop();
+    for (auto& t : accept_threads) t.join();
     
-    g_server.store(nullptr);
+    g_servers.store(nullptr);
 }
 
 void PrintServer::stop() {
@@ -1,11 +1,13 @@
 #include <thread>
 
 #include "printpipe/scheduler.hpp"
+#include "printpipe/trace.hpp"
 
 namespace printpipe {
 
-Scheduler::Scheduler()
-    : spooler_(std::make_shared<TextSpooler>()) {}
+Scheduler::Scheduler(std::size_t workers)
+    : worker_count_(workers ? workers : 1)
+    , spooler_(std::make_shared<TextSpooler>()) {}
 
 Scheduler::~Scheduler() {
     stop();
@@ -16,19 +18,39 @@ void Scheduler::start() {
     if (!running_.compare_exchange_strong(expected, true)) return;
 
     stop_requested_.store(false);
-    worker_ = std::thread([this] { worker_loop(); });
+    workers_.reserve(worker_count_);
+    for (std::size_t i = 0; i < worker_count_; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
 }
 
 void Scheduler::stop() {
     if (!running_.exchange(false)) return;
 
-    stop_requested_.store(true);
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_requested_.store(true);
+    }
     cv_.notify_all();
 
-    if (worker_.joinable()) worker_.join();
+    for (auto& w : workers_) {
+        if (w.joinable()) w.join();
+    }
+    workers_.clear();
 
     std::lock_guard<std::mutex> lk(mu_);
     q_.clear();
+    retries_.clear();
+}
+
+void Scheduler::set_retry_policy(RetryPolicy p) {
+    std::lock_guard<std::mutex> lk(mu_);
+    retry_policy_ = p;
+}
+
+void Scheduler::set_coalescing(CoalescingPolicy p) {
+    std::lock_guard<std::mutex> lk(mu_);
+    coalescing_ = p;
 }
 
 bool Scheduler::submit(std::shared_ptr<Job> job) {
@@ -44,59 +66,284 @@ bool Scheduler::submit(std::shared_ptr<Job> job) {
 }
 
 void Scheduler::worker_loop() {
+    std::vector<std::shared_ptr<Job>> batch;
+
     while (!stop_requested_.load()) {
-        std::shared_ptr<Job> job;
+        batch.clear();
+        if (!next_jobs(batch)) break;
 
-        {
-            std::unique_lock<std::mutex> lk(mu_);
-            cv_.wait(lk, [&] { return stop_requested_.load() || !q_.empty(); });
+        if (batch.size() == 1) run_one(batch.front());
+        else run_batch(batch);
+    }
+}
 
-            if (stop_requested_.load()) break;
-            job = std::move(q_.front());
-            q_.pop_front();
-        }
+bool Scheduler::next_jobs(std::vector<std::shared_ptr<Job>>& out) {
+    std::unique_lock<std::mutex> lk(mu_);
+    std::vector<std::shared_ptr<Job>> due;
 
-        if (!job) continue;
+    for (;;) {
+        if (stop_requested_.load()) return false;
 
-        if (job->state() == JobState::Created) {
-            (void)job->enqueue();
-        }
+        // Retries whose backoff has elapsed rejoin the main queue
+        retries_.advance(std::chrono::steady_clock::now(), due);
+        for (auto& j : due) q_.push_back(std::move(j));
+        due.clear();
+
+        if (!q_.empty()) break;
+        if (auto next = retries_.next_due()) cv_.wait_until(lk, *next);
+        else cv_.wait(lk);
+    }
+
+    out.push_back(std::move(q_.front()));
+    q_.pop_front();
+
+    // ---- Coalescing: gather consecutive small jobs behind this one ----
+    const CoalescingPolicy policy = coalescing_;
+    if (!policy.enabled || !out.front()) return true;
 
-        if (!job->schedule())       continue;
-        if (!job->start_spooling()) continue;
+    std::size_t bytes = out.front()->payload_size();
+    if (bytes > policy.max_job_bytes) return true;
 
-        // Step 2: spool some data (for now: text buffer)
-        if (!spooler_) {
-            if (!Job::is_terminal(job->state())) (void)job->fail();
+    const auto deadline = std::chrono::steady_clock::now() + policy.window;
+    for (;;) {
+        if (!coalesce_queued(out, bytes, policy)) break;
+        if (stop_requested_.load()) break;
+        // Hold the batch open briefly for more small jobs to arrive
+        if (cv_.wait_until(lk, deadline) == std::cv_status::timeout && q_.empty()) break;
+    }
+    // The wait may have taken submit()'s wakeup meant for an idle worker;
+    // pass it on if a job was left behind (e.g. too big to join)
+    if (!q_.empty()) cv_.notify_one();
+    return true;
+}
+
+// Moves queued small jobs into the batch; false once the batch is closed
+// (full, or the next job is too big to join it).
+bool Scheduler::coalesce_queued(std::vector<std::shared_ptr<Job>>& out, std::size_t& bytes,
+                                const CoalescingPolicy& policy) {
+    while (!q_.empty() && out.size() < policy.max_batch_jobs) {
+        const auto& next = q_.front();
+        if (!next) {
+            q_.pop_front();
             continue;
         }
+        const std::size_t n = next->payload_size();
+        if (n > policy.max_job_bytes || bytes + n > policy.max_batch_bytes) return false;
+        bytes += n;
+        out.push_back(std::move(q_.front()));
+        q_.pop_front();
+    }
+    return out.size() < policy.max_batch_jobs;
+}
 
-        SpoolResult sp = spooler_->spool(*job);
-        if (!sp.ok) {
-            if (!Job::is_terminal(job->state())) (void)job->fail();
-            continue;
+bool Scheduler::prepare(Job& job) {
+    if (job.state() == JobState::Created) {
+        (void)job.enqueue();
+    }
+    if (trace::enabled() && job.state() == JobState::Queued) {
+        const auto queued_at = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            job.state_entered_at().time_since_epoch()).count();
+        trace::record("queue_wait", job.id(), queued_at, trace::now_ns());
+    }
+
+    if (!job.schedule() || !job.start_spooling()) {
+        if (job.cancel_requested()) release_canceled(job);
+        return false;
+    }
+
+    // Step 2: spool some data (for now: text buffer)
+    if (!spooler_) {
+        if (!Job::is_terminal(job.state())) (void)job.fail();
+        return false;
+    }
+
+    SpoolResult sp = [&] {
+        trace::Scope span("spool", job.id());
+        return spooler_->spool(job);
+    }();
+    if (!sp.ok) {
+        if (job.cancel_requested()) release_canceled(job);
+        else if (!Job::is_terminal(job.state())) (void)job.fail();
+        return false;
+    }
+    if (sp.buffer) spooled_bytes_.fetch_add(sp.buffer->bytes.size(), std::memory_order_relaxed);
+    if (!job.start_printing()) {
+        if (job.cancel_requested()) release_canceled(job);
+        return false;
+    }
+    return true;
+}
+
+void Scheduler::finish(const std::shared_ptr<Job>& job, std::uint32_t attempt, bool ok,
+                       std::chrono::steady_clock::time_point now) {
+    if (job->cancel_requested()) {
+        release_canceled(*job);
+        return;
+    }
+
+    if (!ok) {
+        if (!schedule_retry(job, attempt, now)) job->fail();
+        return;
+    }
+
+    // If it was canceled while printing, complete() will fail due to terminal state
+    job->complete();
+}
+
+void Scheduler::run_one(const std::shared_ptr<Job>& job) {
+    if (!job || !prepare(*job)) return;
+
+    // ---- Step 3: print via backend ----
+    const std::uint32_t attempt = job->begin_attempt();
+    bool ok = false;
+    if (backend_) {
+        // Spilled payloads are mapped here rather than copied into memory
+        const auto payload = job->payload();
+        PayloadView view;
+        if (payload) view = payload->view();
+        trace::Scope span("print", job->id());
+        ok = (!payload || view.valid()) && backend_->print(*job, view.data());
+        if (ok) printed_bytes_.fetch_add(view.data().size(), std::memory_order_relaxed);
+    } else {
+        // No backend configured => fail fast (keeps behavior explicit)
+        ok = false;
+    }
+
+    finish(job, attempt, ok, std::chrono::steady_clock::now());
+}
+
+void Scheduler::run_batch(const std::vector<std::shared_ptr<Job>>& jobs) {
+    struct Prepared {
+        std::shared_ptr<Job> job;
+        std::uint32_t attempt;
+        PayloadPtr payload;
+        PayloadView view;
+        bool ok = false;
+    };
+
+    std::vector<Prepared> ready;
+    ready.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        if (!job || !prepare(*job)) continue;
+        Prepared p{job, job->begin_attempt(), job->payload(), {}};
+        if (p.payload) p.view = p.payload->view();
+        ready.push_back(std::move(p));
+    }
+
+    // ---- One backend operation for the whole batch ----
+    std::vector<PrintItem> items;
+    std::vector<Prepared*> owners;
+    items.reserve(ready.size());
+    owners.reserve(ready.size());
+    for (auto& p : ready) {
+        if (p.payload && !p.view.valid()) continue;
+        items.push_back(PrintItem{p.job.get(), p.view.data()});
+        owners.push_back(&p);
+    }
+    if (backend_ && !items.empty()) {
+        const std::int64_t start = trace::enabled() ? trace::now_ns() : 0;
+        backend_->print_batch(items);
+        if (start) {
+            // The batch is one backend call; each job shows it as its print
+            const std::int64_t end = trace::now_ns();
+            trace::record("print_batch", 0, start, end);
+            for (const auto& item : items) trace::record("print", item.job->id(), start, end);
         }
-if (!job->start_printing()) continue;
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        batched_jobs_.fetch_add(items.size(), std::memory_order_relaxed);
+    }
+    std::uint64_t printed = 0;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        owners[i]->ok = items[i].ok;
+        if (items[i].ok) printed += items[i].payload.size();
+    }
+    printed_bytes_.fetch_add(printed, std::memory_order_relaxed);
 
-// ---- Step 3: print via backend ----
-bool ok = false;
-if (backend_) {
-    const auto payload = job->payload_copy();
-    ok = backend_->print(*job, payload);
-} else {
-    // No backend configured => fail fast (keeps behavior explicit)
-    ok = false;
+    // ---- Every job still settles on its own ----
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& p : ready) finish(p.job, p.attempt, p.ok, now);
 }
 
-if (!ok) {
-    job->fail();
-    continue;
+bool Scheduler::schedule_retry(const std::shared_ptr<Job>& job, std::uint32_t attempt,
+                               std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lk(mu_);
+    const RetryPolicy& policy = job->retry_policy() ? *job->retry_policy() : retry_policy_;
+    if (attempt >= policy.max_attempts || stop_requested_.load()) return false;
+    if (!job->requeue()) return false;
+
+    const double u = std::uniform_real_distribution<double>(0.0, 1.0)(jitter_rng_);
+    retries_.schedule(job, now + policy.backoff(attempt, u));
+    ++retries_scheduled_;
+    // Another worker may be sleeping on a later deadline
+    cv_.notify_one();
+    return true;
 }
 
-// If it was canceled while printing, complete() will fail due to terminal state
-job->complete();
+void Scheduler::release_canceled(const Job& job) {
+    const auto waited = std::chrono::steady_clock::now() - job.cancel_requested_at();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count();
 
+    cancel_releases_.fetch_add(1, std::memory_order_relaxed);
+    cancel_release_total_ns_.fetch_add(ns, std::memory_order_relaxed);
+    auto prev = cancel_release_max_ns_.load(std::memory_order_relaxed);
+    while (prev < ns && !cancel_release_max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
     }
+    if (cancel_release_observer_) cancel_release_observer_(std::chrono::nanoseconds(ns));
+}
+
+bool Scheduler::poll(std::chrono::steady_clock::time_point now, std::vector<std::shared_ptr<Job>>& out) {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::vector<std::shared_ptr<Job>> due;
+    retries_.advance(now, due);
+    for (auto& j : due) q_.push_back(std::move(j));
+
+    while (!q_.empty() && !q_.front()) q_.pop_front();
+    if (q_.empty()) return false;
+
+    out.push_back(std::move(q_.front()));
+    q_.pop_front();
+
+    const CoalescingPolicy policy = coalescing_;
+    std::size_t bytes = out.front()->payload_size();
+    if (policy.enabled && bytes <= policy.max_job_bytes) coalesce_queued(out, bytes, policy);
+    return true;
+}
+
+bool Scheduler::begin(Job& job) {
+    if (!prepare(job)) return false;
+    (void)job.begin_attempt();
+    return true;
+}
+
+void Scheduler::settle(const std::shared_ptr<Job>& job, bool ok, std::chrono::steady_clock::time_point now) {
+    finish(job, job->attempts(), ok, now);
+}
+
+std::optional<std::chrono::steady_clock::time_point> Scheduler::next_retry_due() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return retries_.next_due();
+}
+
+void Scheduler::set_jitter_seed(std::uint32_t seed) {
+    std::lock_guard<std::mutex> lk(mu_);
+    jitter_rng_.seed(seed);
+}
+
+SchedulerStats Scheduler::stats() const {
+    SchedulerStats s;
+    s.cancel_releases = cancel_releases_.load(std::memory_order_relaxed);
+    s.cancel_release_total = std::chrono::nanoseconds(cancel_release_total_ns_.load(std::memory_order_relaxed));
+    s.cancel_release_max = std::chrono::nanoseconds(cancel_release_max_ns_.load(std::memory_order_relaxed));
+    s.batches = batches_.load(std::memory_order_relaxed);
+    s.batched_jobs = batched_jobs_.load(std::memory_order_relaxed);
+    s.spooled_bytes = spooled_bytes_.load(std::memory_order_relaxed);
+    s.printed_bytes = printed_bytes_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lk(mu_);
+    s.retries_scheduled = retries_scheduled_;
+    s.retries_pending = retries_.size();
+    s.queued = q_.size();
+    return s;
 }
 
 } // namespace printpipe
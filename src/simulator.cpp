@@ -0,0 +1,418 @@
+#include "printpipe/simulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace printpipe {
+namespace sim {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::nanoseconds;
+
+nanoseconds to_ns(double ns) {
+    return nanoseconds(static_cast<std::int64_t>(std::llround(std::max(ns, 0.0))));
+}
+
+// "250us", "1.5ms", "2s"; a bare number is nanoseconds.
+std::optional<double> parse_duration_ns(std::string_view text) {
+    const std::string s(text);
+    char* end = nullptr;
+    const double value = std::strtod(s.c_str(), &end);
+    if (end == s.c_str() || value < 0) return std::nullopt;
+    const std::string_view unit(end);
+    if (unit.empty() || unit == "ns") return value;
+    if (unit == "us") return value * 1e3;
+    if (unit == "ms") return value * 1e6;
+    if (unit == "s") return value * 1e9;
+    return std::nullopt;
+}
+
+std::optional<double> parse_number(std::string_view text) {
+    const std::string s(text);
+    char* end = nullptr;
+    const double value = std::strtod(s.c_str(), &end);
+    if (end == s.c_str() || *end != '\0') return std::nullopt;
+    return value;
+}
+
+std::vector<std::string_view> split(std::string_view text, char sep) {
+    std::vector<std::string_view> parts;
+    for (;;) {
+        const auto pos = text.find(sep);
+        parts.push_back(text.substr(0, pos));
+        if (pos == std::string_view::npos) return parts;
+        text.remove_prefix(pos + 1);
+    }
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+Percentiles summarize(std::vector<std::int64_t>& samples) {
+    Percentiles p;
+    if (samples.empty()) return p;
+    std::sort(samples.begin(), samples.end());
+    long double sum = 0;
+    for (auto v : samples) sum += v;
+    const auto at = [&](double q) {
+        const auto i = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1) + 0.5);
+        return nanoseconds(samples[std::min(i, samples.size() - 1)]);
+    };
+    p.mean = nanoseconds(static_cast<std::int64_t>(sum / samples.size()));
+    p.p50 = at(0.50);
+    p.p99 = at(0.99);
+    p.max = nanoseconds(samples.back());
+    return p;
+}
+
+} // namespace
+
+// ---- Distribution ----
+
+Distribution Distribution::constant(nanoseconds value) {
+    Distribution d;
+    d.kind_ = Kind::Constant;
+    d.a_ = static_cast<double>(value.count());
+    return d;
+}
+
+Distribution Distribution::exponential(nanoseconds mean) {
+    Distribution d;
+    d.kind_ = Kind::Exponential;
+    d.a_ = static_cast<double>(mean.count());
+    return d;
+}
+
+Distribution Distribution::uniform(nanoseconds lo, nanoseconds hi) {
+    Distribution d;
+    d.kind_ = Kind::Uniform;
+    d.a_ = static_cast<double>(std::min(lo, hi).count());
+    d.b_ = static_cast<double>(std::max(lo, hi).count());
+    return d;
+}
+
+Distribution Distribution::lognormal(nanoseconds median, double sigma) {
+    Distribution d;
+    d.kind_ = Kind::LogNormal;
+    d.a_ = static_cast<double>(median.count());
+    d.b_ = sigma;
+    return d;
+}
+
+std::optional<Distribution> Distribution::parse(std::string_view spec) {
+    const auto parts = split(spec, ':');
+    const auto arg = [&](std::size_t i) { return i < parts.size() ? parse_duration_ns(parts[i]) : std::nullopt; };
+
+    if (parts[0] == "const" && parts.size() == 2) {
+        if (auto v = arg(1)) return constant(to_ns(*v));
+    } else if (parts[0] == "exp" && parts.size() == 2) {
+        if (auto v = arg(1)) return exponential(to_ns(*v));
+    } else if (parts[0] == "uniform" && parts.size() == 3) {
+        auto lo = arg(1);
+        auto hi = arg(2);
+        if (lo && hi) return uniform(to_ns(*lo), to_ns(*hi));
+    } else if (parts[0] == "lognormal" && parts.size() == 3) {
+        auto median = arg(1);
+        auto sigma = parse_number(parts[2]);
+        if (median && sigma && *sigma >= 0) return lognormal(to_ns(*median), *sigma);
+    }
+    return std::nullopt;
+}
+
+nanoseconds Distribution::sample(std::mt19937_64& rng) const {
+    switch (kind_) {
+        case Kind::Constant:
+            return to_ns(a_);
+        case Kind::Exponential:
+            return a_ > 0 ? to_ns(std::exponential_distribution<double>(1.0 / a_)(rng)) : nanoseconds(0);
+        case Kind::Uniform:
+            return to_ns(std::uniform_real_distribution<double>(a_, b_)(rng));
+        case Kind::LogNormal:
+            return a_ > 0 ? to_ns(std::lognormal_distribution<double>(std::log(a_), b_)(rng)) : nanoseconds(0);
+    }
+    return nanoseconds(0);
+}
+
+nanoseconds Distribution::mean() const {
+    switch (kind_) {
+        case Kind::Constant:
+        case Kind::Exponential: return to_ns(a_);
+        case Kind::Uniform:     return to_ns((a_ + b_) / 2);
+        case Kind::LogNormal:   return to_ns(a_ * std::exp(b_ * b_ / 2));
+    }
+    return nanoseconds(0);
+}
+
+// ---- Synthetic spooler and backend ----
+
+SyntheticSpooler::SyntheticSpooler(Distribution service, std::uint64_t seed)
+    : service_(service), rng_(seed) {}
+
+SpoolResult SyntheticSpooler::spool(const Job& job) {
+    if (job.cancel_requested()) return SpoolResult{false, std::nullopt, "canceled"};
+    elapsed_ += service_.sample(rng_);
+    return SpoolResult{true, std::nullopt, {}};
+}
+
+nanoseconds SyntheticSpooler::take_elapsed() {
+    return std::exchange(elapsed_, nanoseconds(0));
+}
+
+SyntheticBackend::SyntheticBackend(Distribution setup, Distribution per_document, double failure_rate,
+                                   std::uint64_t seed)
+    : setup_(setup), per_document_(per_document), failure_rate_(failure_rate), rng_(seed) {}
+
+bool SyntheticBackend::print(const Job& job, std::string_view payload) {
+    PrintItem item{&job, payload};
+    print_batch(std::span<PrintItem>(&item, 1));
+    return item.ok;
+}
+
+void SyntheticBackend::print_batch(std::span<PrintItem> items) {
+    elapsed_ += setup_.sample(rng_);
+    for (auto& item : items) {
+        elapsed_ += per_document_.sample(rng_);
+        item.ok = std::uniform_real_distribution<double>(0.0, 1.0)(rng_) >= failure_rate_;
+    }
+}
+
+nanoseconds SyntheticBackend::take_elapsed() {
+    return std::exchange(elapsed_, nanoseconds(0));
+}
+
+// ---- Arrivals ----
+
+bool load_csv(std::istream& in, std::vector<Arrival>& out, std::string& error) {
+    std::string line;
+    std::size_t line_no = 0;
+    bool seen_data = false;
+    while (std::getline(in, line)) {
+        ++line_no;
+        const auto text = trim(line);
+        if (text.empty() || text.front() == '#') continue;
+
+        const auto fields = split(text, ',');
+        const auto seconds = parse_number(trim(fields[0]));
+        if (!seconds) {
+            if (!seen_data) {
+                seen_data = true;   // header
+                continue;
+            }
+            error = "line " + std::to_string(line_no) + ": bad time '" + std::string(fields[0]) + "'";
+            return false;
+        }
+        seen_data = true;
+
+        Arrival a;
+        a.at = to_ns(*seconds * 1e9);
+        if (fields.size() > 1) {
+            const auto bytes = parse_number(trim(fields[1]));
+            if (!bytes || *bytes < 0) {
+                error = "line " + std::to_string(line_no) + ": bad payload size '" + std::string(fields[1]) + "'";
+                return false;
+            }
+            a.payload_bytes = static_cast<std::size_t>(*bytes);
+        }
+        out.push_back(a);
+    }
+    std::stable_sort(out.begin(), out.end(), [](const Arrival& l, const Arrival& r) { return l.at < r.at; });
+    return true;
+}
+
+std::vector<Arrival> poisson_arrivals(double rate, std::size_t jobs, std::size_t payload_bytes, std::uint64_t seed) {
+    std::vector<Arrival> out;
+    if (rate <= 0) return out;
+    out.reserve(jobs);
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> gap(rate);
+    double t = 0;
+    for (std::size_t i = 0; i < jobs; ++i) {
+        t += gap(rng);
+        out.push_back(Arrival{to_ns(t * 1e9), payload_bytes});
+    }
+    return out;
+}
+
+// ---- Simulation ----
+
+Report simulate(const Config& config, std::span<const Arrival> arrivals) {
+    Report report;
+    report.jobs = arrivals.size();
+    if (arrivals.empty()) return report;
+
+    std::vector<Arrival> sorted;
+    if (!std::is_sorted(arrivals.begin(), arrivals.end(),
+                        [](const Arrival& l, const Arrival& r) { return l.at < r.at; })) {
+        sorted.assign(arrivals.begin(), arrivals.end());
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Arrival& l, const Arrival& r) { return l.at < r.at; });
+        arrivals = sorted;
+    }
+
+    auto spooler = std::make_shared<SyntheticSpooler>(config.spool, config.seed * 3 + 1);
+    SyntheticBackend backend(config.print_setup, config.print, config.failure_rate, config.seed * 3 + 2);
+
+    Scheduler sched(config.workers);
+    sched.set_spooler(spooler);
+    sched.set_retry_policy(config.retry);
+    sched.set_coalescing(config.coalescing);
+    sched.set_jitter_seed(static_cast<std::uint32_t>(config.seed));
+    // Virtual time zero, aligned with the retry wheel so ticks land the same way every run
+    const Clock::time_point epoch = sched.created_at();
+
+    // ---- Event queue: completions and retry wake-ups ----
+    enum class EventType : std::uint8_t { WorkerDone, RetryDue };
+    struct Event {
+        nanoseconds at;
+        std::uint64_t seq;
+        EventType type;
+        std::size_t worker;
+    };
+    struct Later {
+        bool operator()(const Event& l, const Event& r) const {
+            return l.at != r.at ? l.at > r.at : l.seq > r.seq;
+        }
+    };
+    std::priority_queue<Event, std::vector<Event>, Later> events;
+    std::uint64_t seq = 0;
+
+    struct Worker {
+        bool busy = false;
+        std::vector<std::shared_ptr<Job>> jobs;
+        std::vector<bool> ok;
+    };
+    std::vector<Worker> workers(std::max<std::size_t>(1, config.workers));
+
+    struct Track {
+        nanoseconds arrival;
+        bool dispatched = false;
+    };
+    std::unordered_map<JobId, Track> tracks;
+
+    std::vector<std::int64_t> queue_delays;
+    std::vector<std::int64_t> sojourns;
+    queue_delays.reserve(arrivals.size());
+    sojourns.reserve(arrivals.size());
+
+    nanoseconds now{0};
+    nanoseconds busy_total{0};
+    nanoseconds last_done{0};
+    nanoseconds wake_at = nanoseconds::max();  // earliest pending RetryDue
+
+    const auto settle_terminal = [&](const Job& job) {
+        auto it = tracks.find(job.id());
+        if (it == tracks.end()) return;
+        sojourns.push_back((now - it->second.arrival).count());
+        if (job.state() == JobState::Completed) ++report.completed;
+        else ++report.failed;
+        last_done = now;
+        tracks.erase(it);
+    };
+
+    std::vector<std::shared_ptr<Job>> polled;
+    std::vector<PrintItem> items;
+    const auto dispatch = [&] {
+        bool idle_left = false;
+        for (std::size_t w = 0; w < workers.size(); ++w) {
+            Worker& worker = workers[w];
+            while (!worker.busy) {
+                polled.clear();
+                if (!sched.poll(epoch + now, polled)) {
+                    idle_left = true;
+                    break;
+                }
+                for (auto& job : polled) {
+                    auto& track = tracks[job->id()];
+                    if (!track.dispatched) {
+                        track.dispatched = true;
+                        queue_delays.push_back((now - track.arrival).count());
+                    }
+                    if (sched.begin(*job)) worker.jobs.push_back(job);
+                    else if (Job::is_terminal(job->state())) settle_terminal(*job);
+                }
+                nanoseconds service = spooler->take_elapsed();
+                if (!worker.jobs.empty()) {
+                    items.clear();
+                    for (const auto& job : worker.jobs) items.push_back(PrintItem{job.get(), {}});
+                    backend.print_batch(items);
+                    service += backend.take_elapsed();
+                    for (const auto& item : items) worker.ok.push_back(item.ok);
+                    report.attempts += items.size();
+                    ++report.batches;
+                    worker.busy = true;
+                }
+                if (worker.busy || service > nanoseconds(0)) {
+                    busy_total += service;
+                    worker.busy = true;
+                    events.push(Event{now + service, seq++, EventType::WorkerDone, w});
+                }
+            }
+            if (idle_left) break;
+        }
+        // Only an idle worker would pick up a retry; busy ones poll when done
+        if (!idle_left) return;
+        if (auto due = sched.next_retry_due()) {
+            const nanoseconds at = std::max(now, std::chrono::duration_cast<nanoseconds>(*due - epoch));
+            if (at < wake_at) {
+                wake_at = at;
+                events.push(Event{at, seq++, EventType::RetryDue, 0});
+            }
+        }
+    };
+
+    std::size_t next_arrival = 0;
+    while (next_arrival < arrivals.size() || !events.empty()) {
+        // Completions at the same instant free workers before new arrivals
+        const bool take_event = !events.empty() &&
+            (next_arrival == arrivals.size() || events.top().at <= arrivals[next_arrival].at);
+
+        if (take_event) {
+            const Event ev = events.top();
+            events.pop();
+            now = ev.at;
+            if (ev.type == EventType::RetryDue) {
+                if (wake_at <= now) wake_at = nanoseconds::max();
+            } else {
+                Worker& worker = workers[ev.worker];
+                for (std::size_t i = 0; i < worker.jobs.size(); ++i) {
+                    sched.settle(worker.jobs[i], worker.ok[i], epoch + now);
+                    if (Job::is_terminal(worker.jobs[i]->state())) settle_terminal(*worker.jobs[i]);
+                }
+                worker.jobs.clear();
+                worker.ok.clear();
+                worker.busy = false;
+            }
+        } else {
+            const Arrival& a = arrivals[next_arrival++];
+            now = a.at;
+            auto job = std::make_shared<Job>("sim");
+            if (a.payload_bytes) job->set_payload(std::string(a.payload_bytes, 'x'));
+            tracks.emplace(job->id(), Track{now});
+            sched.submit(std::move(job));
+            report.max_queue_depth = std::max(report.max_queue_depth, sched.stats().queued);
+        }
+        dispatch();
+    }
+
+    report.makespan = std::max(nanoseconds(0), last_done - arrivals.front().at);
+    const double seconds = std::chrono::duration<double>(report.makespan).count();
+    if (seconds > 0) {
+        report.throughput = static_cast<double>(report.completed + report.failed) / seconds;
+        report.utilization = std::chrono::duration<double>(busy_total).count() /
+                             (seconds * static_cast<double>(workers.size()));
+    }
+    report.queue_delay = summarize(queue_delays);
+    report.sojourn = summarize(sojourns);
+    return report;
+}
+
+} // namespace sim
+} // namespace printpipe
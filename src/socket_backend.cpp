@@ -0,0 +1,259 @@
+#include "printpipe/socket_backend.hpp"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+#include "printpipe/job.hpp"
+
+namespace printpipe {
+
+namespace {
+
+// Payload is split into iovecs of this size so cancellation is checked
+// at least this often.
+constexpr std::size_t kChunkSize = 1 << 20;
+constexpr std::size_t kMaxIov = 16;
+constexpr int kPollSliceMs = 50;
+
+int remaining_ms(std::chrono::steady_clock::time_point deadline) {
+    // Rounded up so a wait never ends before the deadline
+    auto left = std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    return static_cast<int>(std::max<decltype(left)>(left, 0));
+}
+
+// A pooled connection is usable if the peer hasn't closed it or sent
+// anything (raw printers normally stay silent).
+bool still_open(int fd) {
+    pollfd p{fd, POLLIN, 0};
+    return ::poll(&p, 1, 0) == 0;
+}
+
+} // namespace
+
+SocketBackend::SocketBackend(SocketBackendOptions opts)
+    : opts_(std::move(opts)) {}
+
+SocketBackend::~SocketBackend() {
+    for (const auto& c : idle_) ::close(c.fd);
+}
+
+int SocketBackend::connect_new() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    const auto port = std::to_string(opts_.port);
+    if (::getaddrinfo(opts_.host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+
+    const auto deadline = Clock::now() + opts_.connect_timeout;
+    int fd = -1;
+    for (addrinfo* ai = res; ai && fd < 0; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) continue;
+
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            int err = errno;
+            if (err == EINPROGRESS) {
+                pollfd p{fd, POLLOUT, 0};
+                socklen_t len = sizeof(err);
+                if (::poll(&p, 1, remaining_ms(deadline)) != 1
+                    || ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) {
+                    err = ETIMEDOUT;
+                }
+            }
+            if (err != 0) {
+                ::close(fd);
+                fd = -1;
+                continue;
+            }
+        }
+
+        int one = 1;
+        (void)::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    ::freeaddrinfo(res);
+
+    if (fd >= 0) connects_.fetch_add(1, std::memory_order_relaxed);
+    return fd;
+}
+
+int SocketBackend::acquire(bool& reused) {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        const auto now = Clock::now();
+        while (!idle_.empty()) {
+            Idle c = idle_.back();
+            idle_.pop_back();
+            if (now - c.since <= opts_.idle_timeout && still_open(c.fd)) {
+                reused = true;
+                reuses_.fetch_add(1, std::memory_order_relaxed);
+                return c.fd;
+            }
+            ::close(c.fd);
+        }
+    }
+    reused = false;
+    return connect_new();
+}
+
+void SocketBackend::release(int fd) {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (idle_.size() < opts_.max_idle_connections) {
+            idle_.push_back(Idle{fd, Clock::now()});
+            return;
+        }
+    }
+    ::close(fd);
+}
+
+bool SocketBackend::wait_writable(int fd, const std::stop_token& token,
+                                  Clock::time_point deadline) const {
+    // Device is applying back-pressure; wait for room in short slices so a
+    // cancel is noticed, and give up once the write's deadline has passed.
+    while (!token.stop_requested()) {
+        const int left = remaining_ms(deadline);
+        if (left == 0) return false;
+        pollfd p{fd, POLLOUT, 0};
+        const int r = ::poll(&p, 1, std::min(left, kPollSliceMs));
+        if (r < 0 && errno != EINTR) return false;
+        if (r == 1) return !(p.revents & (POLLERR | POLLHUP));
+    }
+    return true;    // caller sees the cancel on its next check
+}
+
+SocketBackend::SendResult SocketBackend::send_documents(int fd, std::span<const std::string_view> docs,
+                                                        const std::stop_token& token,
+                                                        Clock::time_point deadline, std::size_t& sent) {
+    // ---- Build the scatter list: preamble, payload chunks, trailer per document ----
+    std::vector<iovec> iov;
+    auto push = [&](const char* p, std::size_t n) {
+        if (n) iov.push_back(iovec{const_cast<char*>(p), n});
+    };
+    for (const auto& doc : docs) {
+        push(opts_.preamble.data(), opts_.preamble.size());
+        for (std::size_t off = 0; off < doc.size(); off += kChunkSize) {
+            push(doc.data() + off, std::min(kChunkSize, doc.size() - off));
+        }
+        push(opts_.trailer.data(), opts_.trailer.size());
+    }
+
+    std::size_t first = 0;
+    sent = 0;
+
+    while (first < iov.size()) {
+        if (token.stop_requested()) return SendResult::Canceled;
+
+        msghdr msg{};
+        msg.msg_iov = iov.data() + first;
+        msg.msg_iovlen = std::min(kMaxIov, iov.size() - first);
+
+        const ssize_t n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_writable(fd, token, deadline)) continue;
+            return sent == 0 ? SendResult::FailedUntouched : SendResult::Failed;
+        }
+
+        sent += static_cast<std::size_t>(n);
+        auto left = static_cast<std::size_t>(n);
+        while (left > 0 && left >= iov[first].iov_len) {
+            left -= iov[first].iov_len;
+            ++first;
+        }
+        if (left > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+    return SendResult::Ok;
+}
+
+SocketBackend::SendResult SocketBackend::send_with_reconnect(int& fd, bool reused,
+                                                             std::span<const std::string_view> docs,
+                                                             const std::stop_token& token,
+                                                             Clock::time_point deadline, std::size_t& sent) {
+    SendResult r = send_documents(fd, docs, token, deadline, sent);
+    if (r == SendResult::FailedUntouched && reused) {
+        // The pooled connection went stale; retry once on a fresh one
+        ::close(fd);
+        fd = connect_new();
+        r = fd < 0 ? SendResult::Failed : send_documents(fd, docs, token, deadline, sent);
+    }
+
+    if (r == SendResult::Ok) {
+        release(fd);
+    } else {
+        // Failed or canceled mid-stream: the connection is unusable, drop it
+        if (fd >= 0) ::close(fd);
+        if (r != SendResult::Canceled) failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+    fd = -1;
+    return r;
+}
+
+bool SocketBackend::print(const Job& job, std::string_view payload) {
+    bool reused = false;
+    int fd = acquire(reused);
+    if (fd < 0) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // write_timeout bounds the whole document, not each stall
+    const auto deadline = Clock::now() + opts_.write_timeout;
+    std::size_t sent = 0;
+    const std::string_view docs[] = {payload};
+    return send_with_reconnect(fd, reused, docs, job.cancel_token(), deadline, sent) == SendResult::Ok;
+}
+
+void SocketBackend::print_batch(std::span<PrintItem> items) {
+    std::vector<std::string_view> docs;
+    std::vector<PrintItem*> live;
+    docs.reserve(items.size());
+    live.reserve(items.size());
+    for (auto& item : items) {
+        item.ok = false;
+        if (item.job->cancel_requested()) continue;
+        docs.push_back(item.payload);
+        live.push_back(&item);
+    }
+    if (docs.empty()) return;
+
+    bool reused = false;
+    int fd = acquire(reused);
+    if (fd < 0) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Small documents: cancellation is settled per job by the scheduler
+    const auto deadline = Clock::now() + opts_.write_timeout;
+    std::size_t sent = 0;
+    const SendResult r = send_with_reconnect(fd, reused, docs, std::stop_token{}, deadline, sent);
+
+    std::size_t end = 0;
+    for (std::size_t i = 0; i < docs.size(); ++i) {
+        end += opts_.preamble.size() + docs[i].size() + opts_.trailer.size();
+        live[i]->ok = r == SendResult::Ok || end <= sent;
+    }
+}
+
+SocketBackendStats SocketBackend::stats() const {
+    return SocketBackendStats{
+        connects_.load(std::memory_order_relaxed),
+        reuses_.load(std::memory_order_relaxed),
+        failures_.load(std::memory_order_relaxed)};
+}
+
+} // namespace printpipe
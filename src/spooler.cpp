@@ -5,6 +5,10 @@
 namespace printpipe {
 
 SpoolResult TextSpooler::spool(const Job& job) {
+    if (job.cancel_requested()) {
+        return SpoolResult{false, std::nullopt, "canceled"};
+    }
+
     std::ostringstream oss;
     oss << "=== PrintPipe Spool ===\n";
     oss << "Job: " << job.name() << "\n";
@@ -0,0 +1,320 @@
+#include "printpipe/static_assets.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include "printpipe/log.hpp"
+
+#if defined(PRINTPIPE_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace printpipe {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct MimeType {
+    std::string_view ext;
+    std::string_view type;
+    bool compressible;
+};
+
+constexpr MimeType kMimeTypes[] = {
+    {".html", "text/html; charset=utf-8", true},
+    {".htm", "text/html; charset=utf-8", true},
+    {".css", "text/css; charset=utf-8", true},
+    {".js", "text/javascript; charset=utf-8", true},
+    {".mjs", "text/javascript; charset=utf-8", true},
+    {".json", "application/json", true},
+    {".map", "application/json", true},
+    {".svg", "image/svg+xml", true},
+    {".txt", "text/plain; charset=utf-8", true},
+    {".xml", "application/xml", true},
+    {".wasm", "application/wasm", true},
+    {".ico", "image/x-icon", true},
+    {".png", "image/png", false},
+    {".jpg", "image/jpeg", false},
+    {".jpeg", "image/jpeg", false},
+    {".gif", "image/gif", false},
+    {".webp", "image/webp", false},
+    {".woff", "font/woff", false},
+    {".woff2", "font/woff2", false},
+};
+
+const MimeType* mime_for(const fs::path& file) {
+    const std::string ext = file.extension().string();
+    for (const auto& m : kMimeTypes) {
+        if (ext.size() != m.ext.size()) continue;
+        bool same = true;
+        for (std::size_t i = 0; i < ext.size() && same; ++i) {
+            same = (ext[i] | 0x20) == m.ext[i] || ext[i] == m.ext[i];
+        }
+        if (same) return &m;
+    }
+    return nullptr;
+}
+
+std::string quoted_hash(std::string_view data, std::string_view suffix) {
+    // FNV-1a: strong enough to tell versions of one file apart
+    std::uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "\"%016llx%.*s\"", static_cast<unsigned long long>(h),
+                  static_cast<int>(suffix.size()), suffix.data());
+    return buf;
+}
+
+std::string gzip(std::string_view data) {
+#if defined(PRINTPIPE_HAVE_ZLIB)
+    z_stream zs{};
+    // 15 window bits + 16 selects the gzip wrapper
+    if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) return {};
+    std::string out(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+    const int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END) return {};
+    return out;
+#else
+    (void)data;
+    return {};
+#endif
+}
+
+bool hidden(const fs::path& relative) {
+    for (const auto& part : relative) {
+        const auto& s = part.native();
+        if (!s.empty() && s[0] == '.') return true;
+    }
+    return false;
+}
+
+#if defined(__linux__)
+constexpr std::uint32_t kWatchMask =
+    IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF;
+
+// Watches the root and every visible subdirectory; re-adding an existing
+// watch is harmless, so this also runs after each reload.
+bool add_watches(int fd, const fs::path& root) {
+    if (inotify_add_watch(fd, root.c_str(), kWatchMask) < 0) return false;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        if (!it->is_directory(ec)) continue;
+        if (hidden(it->path().lexically_relative(root))) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        (void)inotify_add_watch(fd, it->path().c_str(), kWatchMask);
+    }
+    return true;
+}
+
+void drain(int fd) {
+    alignas(inotify_event) char buf[4096];
+    while (::read(fd, buf, sizeof(buf)) > 0) {
+    }
+}
+#endif
+
+} // namespace
+
+StaticAssets::StaticAssets(std::filesystem::path root)
+    : root_(std::move(root)), table_(std::make_shared<const Table>()) {}
+
+StaticAssets::~StaticAssets() {
+#if defined(__linux__)
+    if (watcher_.joinable()) {
+        const std::uint64_t one = 1;
+        (void)::write(wake_fd_, &one, sizeof(one));
+        watcher_.join();
+    }
+    if (watch_fd_ >= 0) ::close(watch_fd_);
+    if (wake_fd_ >= 0) ::close(wake_fd_);
+#endif
+}
+
+std::size_t StaticAssets::reload() {
+    auto table = std::make_shared<Table>();
+    std::size_t raw_bytes = 0;
+    std::size_t gzip_bytes = 0;
+
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(root_, fs::directory_options::skip_permission_denied, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        const fs::path relative = it->path().lexically_relative(root_);
+        if (hidden(relative)) {
+            if (it->is_directory(ec)) it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file(ec)) continue;
+        if (it->file_size(ec) > kMaxFileBytes) {
+            PRINTPIPE_LOG_WARN("[StaticAssets] Skipping %s: larger than %zu bytes", it->path().c_str(), kMaxFileBytes);
+            continue;
+        }
+
+        std::ifstream in(it->path(), std::ios::binary);
+        if (!in) continue;
+        auto asset = std::make_shared<StaticAsset>();
+        asset->body.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        const MimeType* mime = mime_for(it->path());
+        asset->content_type = mime ? std::string(mime->type) : "application/octet-stream";
+        asset->etag = quoted_hash(asset->body, "");
+        if (mime && mime->compressible && asset->body.size() >= 256) {
+            std::string packed = gzip(asset->body);
+            if (!packed.empty() && packed.size() < asset->body.size()) {
+                asset->gzip = std::move(packed);
+                asset->gzip_etag = quoted_hash(asset->body, "-gz");
+            }
+        }
+        raw_bytes += asset->body.size();
+        gzip_bytes += asset->gzip.empty() ? asset->body.size() : asset->gzip.size();
+
+        table->emplace("/" + relative.generic_string(), std::move(asset));
+    }
+
+    const std::size_t count = table->size();
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        table_ = std::move(table);
+    }
+    if (count) {
+        PRINTPIPE_LOG_INFO("[StaticAssets] Loaded %zu files from %s (%zu bytes, %zu after compression)",
+                           count, root_.c_str(), raw_bytes, gzip_bytes);
+    }
+    return count;
+}
+
+StaticAssetPtr StaticAssets::find(std::string_view url_path) const {
+    std::shared_ptr<const Table> table;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        table = table_;
+    }
+    std::string key(url_path);
+    if (key.empty() || key.back() == '/') key += "index.html";
+    auto it = table->find(key);
+    if (it == table->end()) it = table->find(key + "/index.html");
+    return it == table->end() ? nullptr : it->second;
+}
+
+std::size_t StaticAssets::size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return table_->size();
+}
+
+bool StaticAssets::gzip_supported() noexcept {
+#if defined(PRINTPIPE_HAVE_ZLIB)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool StaticAssets::watch() {
+#if defined(__linux__)
+    if (watcher_.joinable()) return true;
+    watch_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch_fd_ < 0) return false;
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0 || !add_watches(watch_fd_, root_)) {
+        ::close(watch_fd_);
+        watch_fd_ = -1;
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        wake_fd_ = -1;
+        return false;
+    }
+    watcher_ = std::thread([this] { watch_loop(); });
+    return true;
+#else
+    return false;
+#endif
+}
+
+void StaticAssets::watch_loop() {
+#if defined(__linux__)
+    pollfd fds[2] = {{watch_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    for (;;) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        // Editors and deploys save in bursts (temp file, rename); let the
+        // burst settle so one reload covers it
+        do {
+            drain(watch_fd_);
+        } while (::poll(fds, 2, 50) > 0 && !fds[1].revents);
+        if (fds[1].revents) return;
+
+        reload();
+        add_watches(watch_fd_, root_);
+    }
+#endif
+}
+
+bool etag_matches(std::string_view if_none_match, std::string_view etag) noexcept {
+    while (!if_none_match.empty()) {
+        const auto comma = if_none_match.find(',');
+        std::string_view tag = if_none_match.substr(0, comma);
+        while (!tag.empty() && tag.front() == ' ') tag.remove_prefix(1);
+        while (!tag.empty() && tag.back() == ' ') tag.remove_suffix(1);
+        // If-None-Match uses weak comparison, so W/"x" matches "x"
+        if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+        if (tag == "*" || tag == etag) return true;
+        if (comma == std::string_view::npos) break;
+        if_none_match.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+bool accepts_gzip(std::string_view accept_encoding) noexcept {
+    while (!accept_encoding.empty()) {
+        const auto comma = accept_encoding.find(',');
+        std::string_view item = accept_encoding.substr(0, comma);
+        while (!item.empty() && item.front() == ' ') item.remove_prefix(1);
+
+        const auto semi = item.find(';');
+        std::string_view coding = item.substr(0, semi);
+        while (!coding.empty() && coding.back() == ' ') coding.remove_suffix(1);
+        if (coding == "gzip" || coding == "*") {
+            // Only an explicit q=0 refuses it
+            if (semi == std::string_view::npos) return true;
+            std::string_view params = item.substr(semi + 1);
+            while (!params.empty() && params.front() == ' ') params.remove_prefix(1);
+            if (params.substr(0, 2) != "q=") return true;
+            params.remove_prefix(2);
+            for (char c : params) {
+                if (c >= '1' && c <= '9') return true;
+            }
+            return false;
+        }
+        if (comma == std::string_view::npos) break;
+        accept_encoding.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+} // namespace printpipe
@@ -0,0 +1,222 @@
+#include "printpipe/trace.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace printpipe {
+namespace trace {
+
+namespace detail {
+std::atomic<bool> g_enabled{false};
+} // namespace detail
+
+namespace {
+
+static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+// Slots are written only by the owning thread and read by collect(); the
+// fields are atomics so a concurrent read is a stale value, never UB.
+struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<JobId> job{0};
+    std::atomic<std::int64_t> start{0};
+    std::atomic<std::int64_t> dur{0};
+};
+
+struct Ring {
+    std::uint32_t id = 0;
+    std::atomic<std::uint64_t> head{0};     // spans ever written
+    Slot slots[kRingCapacity];
+};
+
+struct Rings {
+    std::mutex mu;
+    std::vector<std::unique_ptr<Ring>> all;
+    std::vector<Ring*> free;                // released by exited threads
+    std::set<std::string, std::less<>> names;
+};
+
+// Leaked on purpose: threads may still record during static destruction.
+Rings& rings() {
+    static Rings* r = new Rings;
+    return *r;
+}
+
+Ring* acquire_ring() {
+    auto& rs = rings();
+    std::lock_guard<std::mutex> lk(rs.mu);
+    if (!rs.free.empty()) {
+        Ring* r = rs.free.back();
+        rs.free.pop_back();
+        return r;
+    }
+    rs.all.push_back(std::make_unique<Ring>());
+    rs.all.back()->id = static_cast<std::uint32_t>(rs.all.size());
+    return rs.all.back().get();
+}
+
+// Hands the ring back when the thread exits; its spans stay readable
+// until another thread reuses it.
+struct ThreadRing {
+    Ring* ring = nullptr;
+    ~ThreadRing() {
+        if (!ring) return;
+        auto& rs = rings();
+        std::lock_guard<std::mutex> lk(rs.mu);
+        rs.free.push_back(ring);
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+void append_escaped(std::string& out, const char* s) {
+    for (; s && *s; ++s) {
+        const char c = *s;
+        if (c == '"' || c == '\\') out.push_back('\\');
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out.push_back(c);
+    }
+}
+
+void append_micros(std::string& out, std::int64_t ns) {
+    char buf[32];
+    const int n = std::snprintf(buf, sizeof(buf), "%lld.%03lld",
+                                static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+    out.append(buf, static_cast<std::size_t>(n));
+}
+
+int g_signal_pipe[2] = {-1, -1};
+
+void on_dump_signal(int) {
+    const char b = 1;
+    (void)!::write(g_signal_pipe[1], &b, 1);
+}
+
+} // namespace
+
+void set_enabled(bool on) noexcept {
+    detail::g_enabled.store(on, std::memory_order_relaxed);
+}
+
+void record(const char* name, JobId job, std::int64_t start_ns, std::int64_t end_ns) noexcept {
+    Ring* r = t_ring.ring;
+    if (!r) {
+        try {
+            r = t_ring.ring = acquire_ring();
+        } catch (...) {
+            return;
+        }
+    }
+
+    const std::uint64_t h = r->head.load(std::memory_order_relaxed);
+    // Publishes the previous head before this slot is overwritten, so a
+    // reader that sees any of the new fields also sees head >= h.
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& s = r->slots[h & (kRingCapacity - 1)];
+    s.name.store(name, std::memory_order_relaxed);
+    s.job.store(job, std::memory_order_relaxed);
+    s.start.store(start_ns, std::memory_order_relaxed);
+    s.dur.store(end_ns - start_ns, std::memory_order_relaxed);
+    r->head.store(h + 1, std::memory_order_release);
+}
+
+const char* intern(std::string_view name) {
+    auto& rs = rings();
+    std::lock_guard<std::mutex> lk(rs.mu);
+    auto it = rs.names.find(name);
+    if (it == rs.names.end()) it = rs.names.emplace(name).first;
+    return it->c_str();
+}
+
+std::vector<Span> collect(std::optional<JobId> job) {
+    std::vector<Span> out;
+    auto& rs = rings();
+    std::lock_guard<std::mutex> lk(rs.mu);
+
+    for (const auto& r : rs.all) {
+        const std::uint64_t h1 = r->head.load(std::memory_order_acquire);
+        const std::uint64_t first = h1 > kRingCapacity ? h1 - kRingCapacity : 0;
+        const std::size_t mark = out.size();
+        std::vector<std::uint64_t> index;
+
+        for (std::uint64_t i = first; i < h1; ++i) {
+            const Slot& s = r->slots[i & (kRingCapacity - 1)];
+            const JobId id = s.job.load(std::memory_order_relaxed);
+            if (job && id != *job) continue;
+            out.push_back(Span{s.name.load(std::memory_order_relaxed), id, r->id,
+                               s.start.load(std::memory_order_relaxed), s.dur.load(std::memory_order_relaxed)});
+            index.push_back(i);
+        }
+
+        // Drop slots the owner may have overwritten while we were copying
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t h2 = r->head.load(std::memory_order_relaxed);
+        if (h2 >= kRingCapacity) {
+            const std::uint64_t safe = h2 - kRingCapacity + 1;
+            std::size_t keep = mark;
+            for (std::size_t k = mark; k < out.size(); ++k) {
+                if (index[k - mark] >= safe) out[keep++] = out[k];
+            }
+            out.resize(keep);
+        }
+    }
+
+    std::sort(out.begin(), out.end(), [](const Span& a, const Span& b) { return a.start_ns < b.start_ns; });
+    return out;
+}
+
+std::string to_chrome_json(const std::vector<Span>& spans) {
+    std::string out;
+    out.reserve(64 + spans.size() * 96);
+    out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& s : spans) {
+        if (!first) out.push_back(',');
+        first = false;
+        out += "{\"name\":\"";
+        append_escaped(out, s.name);
+        out += s.job ? "\",\"cat\":\"job\",\"ph\":\"X\",\"ts\":" : "\",\"cat\":\"server\",\"ph\":\"X\",\"ts\":";
+        append_micros(out, s.start_ns);
+        out += ",\"dur\":";
+        append_micros(out, s.dur_ns);
+        out += ",\"pid\":1,\"tid\":" + std::to_string(s.tid);
+        if (s.job) out += ",\"args\":{\"job_id\":" + std::to_string(s.job) + "}";
+        out.push_back('}');
+    }
+    out += "]}";
+    return out;
+}
+
+bool dump_on_signal(int signo, std::filesystem::path out) {
+    if (g_signal_pipe[0] >= 0) return false;
+    if (::pipe2(g_signal_pipe, O_CLOEXEC) != 0) return false;
+
+    std::thread([fd = g_signal_pipe[0], out = std::move(out)] {
+        for (;;) {
+            char b;
+            const ssize_t n = ::read(fd, &b, 1);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;
+            std::ofstream(out, std::ios::binary | std::ios::trunc) << to_chrome_json(collect());
+        }
+    }).detach();
+
+    struct sigaction sa{};
+    sa.sa_handler = on_dump_signal;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    return ::sigaction(signo, &sa, nullptr) == 0;
+}
+
+} // namespace trace
+} // namespace printpipe
@@ -0,0 +1,144 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/backend_pool.hpp"
+#include "printpipe/job.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+namespace {
+
+class SlowBackend final : public IBackend {
+public:
+    explicit SlowBackend(bool ok = true) : ok_(ok) {}
+
+    bool print(const Job&, std::string_view) override {
+        const int now = ++active_;
+        int seen = peak_.load();
+        while (now > seen && !peak_.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(5ms);
+        --active_;
+        ++calls_;
+        return ok_;
+    }
+
+    bool ok_;
+    std::atomic<int> active_{0};
+    std::atomic<int> peak_{0};
+    std::atomic<int> calls_{0};
+};
+
+// Can be held inside print() to keep a call in flight.
+class GatedBackend final : public IBackend {
+public:
+    bool print(const Job&, std::string_view) override {
+        ++calls_;
+        while (hold_) std::this_thread::sleep_for(1ms);
+        return ok_;
+    }
+
+    std::atomic<bool> ok_{true};
+    std::atomic<bool> hold_{false};
+    std::atomic<int> calls_{0};
+};
+
+} // namespace
+
+TEST_CASE("Pool spreads concurrent prints and honors in-flight limits") {
+    auto a = std::make_shared<SlowBackend>();
+    auto b = std::make_shared<SlowBackend>();
+    BackendPool pool;
+    pool.add(a, 1);
+    pool.add(b, 1);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            Job job{"doc"};
+            for (int i = 0; i < 5; ++i) (void)pool.print(job, "x");
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    REQUIRE(a->calls_ + b->calls_ == 20);
+    REQUIRE(a->calls_ > 0);
+    REQUIRE(b->calls_ > 0);
+    REQUIRE(a->peak_ == 1);
+    REQUIRE(b->peak_ == 1);
+}
+
+TEST_CASE("Pool routes around a backend that keeps failing") {
+    auto bad = std::make_shared<SlowBackend>(false);
+    auto good = std::make_shared<SlowBackend>(true);
+    BackendPool pool{BackendPoolOptions{.max_in_flight = 4, .failure_threshold = 2,
+                                        .ejection_period = 10s}};
+    pool.add(bad);
+    pool.add(good);
+
+    Job job{"doc"};
+    for (int i = 0; i < 40; ++i) (void)pool.print(job, "x");
+
+    REQUIRE(bad->calls_ == 2);
+    REQUIRE(good->calls_ == 38);
+    auto stats = pool.stats();
+    REQUIRE_FALSE(stats[0].healthy);
+    REQUIRE(stats[1].healthy);
+    REQUIRE(stats[1].printed == 38);
+}
+
+TEST_CASE("Pool lets one probe through once an ejection runs out") {
+    auto flaky = std::make_shared<GatedBackend>();
+    auto good = std::make_shared<SlowBackend>(true);
+    BackendPool pool{BackendPoolOptions{.max_in_flight = 4, .failure_threshold = 1,
+                                        .ejection_period = 20ms}};
+    pool.add(flaky);
+    pool.add(good);
+
+    flaky->ok_ = false;
+    Job job{"doc"};
+    for (int i = 0; i < 100 && flaky->calls_ == 0; ++i) (void)pool.print(job, "x");
+    REQUIRE(flaky->calls_ == 1);
+    REQUIRE_FALSE(pool.stats()[0].healthy);
+
+    // Recovered, but the probe is held in flight: nothing else may follow it
+    std::this_thread::sleep_for(30ms);
+    flaky->ok_ = true;
+    flaky->hold_ = true;
+    const int good_before = good->calls_;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            Job j{"doc"};
+            for (int i = 0; i < 10; ++i) (void)pool.print(j, "x");
+        });
+    }
+    // The three threads not stuck behind the probe finish all their prints
+    for (int i = 0; i < 2000 && good->calls_ < good_before + 30; ++i) std::this_thread::sleep_for(1ms);
+    const int probes = flaky->calls_ - 1;
+    const bool healthy_during_probe = pool.stats()[0].healthy;
+
+    flaky->hold_ = false;
+    for (auto& t : threads) t.join();
+    REQUIRE(probes == 1);
+    REQUIRE_FALSE(healthy_during_probe);
+    REQUIRE(good->calls_ - good_before + flaky->calls_ - 1 == 40);
+    REQUIRE(pool.stats()[0].healthy);
+}
+
+TEST_CASE("Pool does not eject a backend for canceled prints") {
+    auto canceled = std::make_shared<SlowBackend>(false);   // as if interrupted
+    BackendPool pool{BackendPoolOptions{.max_in_flight = 1, .failure_threshold = 3,
+                                        .ejection_period = 10s}};
+    pool.add(canceled);
+
+    for (int i = 0; i < 3; ++i) {
+        Job job{"doc"};
+        REQUIRE(job.cancel());
+        REQUIRE_FALSE(pool.print(job, "x"));
+    }
+    REQUIRE(canceled->calls_ == 3);
+    REQUIRE(pool.stats()[0].healthy);
+}
@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/ipp.hpp"
+#include "printpipe/job_registry.hpp"
+#include "printpipe/scheduler.hpp"
+
+#include <mutex>
+#include <thread>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+namespace {
+
+class CaptureBackend final : public IBackend {
+public:
+    bool print(const Job&, std::string_view payload) override {
+        std::lock_guard<std::mutex> lk(mu_);
+        last_.assign(payload);
+        return true;
+    }
+
+    std::string last() {
+        std::lock_guard<std::mutex> lk(mu_);
+        return last_;
+    }
+
+private:
+    std::mutex mu_;
+    std::string last_;
+};
+
+ipp::MessageWriter request(ipp::Operation op, std::uint32_t request_id) {
+    ipp::MessageWriter w(static_cast<std::uint16_t>(op), request_id);
+    w.begin_group(ipp::tag::OperationAttributes);
+    w.add(ipp::tag::Charset, "attributes-charset", "utf-8");
+    w.add(ipp::tag::NaturalLanguage, "attributes-natural-language", "en");
+    w.add(ipp::tag::Uri, "printer-uri", "ipp://localhost/ipp/print");
+    return w;
+}
+
+// Feeds `bytes` in small uneven chunks, as a socket would deliver them.
+std::string roundtrip(IppPrinter& printer, std::string_view bytes, std::size_t chunk = 7) {
+    IppPrinter::Exchange ex(printer);
+    for (std::size_t i = 0; i < bytes.size(); i += chunk) {
+        if (!ex.write(bytes.data() + i, std::min(chunk, bytes.size() - i))) break;
+    }
+    return ex.finish();
+}
+
+// Decodes a response in place; attribute values point into `bytes`.
+// An unparseable response gets a code no server sends.
+ipp::Message parse(const std::string& bytes) {
+    ipp::Message m;
+    std::size_t header_len = 0;
+    if (ipp::parse_message(bytes, m, header_len) != ipp::ParseStatus::Complete || header_len != bytes.size()) {
+        m.code = 0xffff;
+    }
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("IPP parser reads attributes in place and waits for the end tag") {
+    auto w = request(ipp::Operation::PrintJob, 42);
+    w.add(ipp::tag::NameWithoutLanguage, "job-name", "report");
+    w.add(ipp::tag::Keyword, "", "second-value");
+    const std::string header = w.finish();
+    const std::string bytes = header + "DOCUMENT";
+
+    ipp::Message m;
+    std::size_t header_len = 0;
+    REQUIRE(ipp::parse_message(std::string_view(bytes).substr(0, header.size() - 1), m, header_len)
+            == ipp::ParseStatus::NeedMore);
+    REQUIRE(ipp::parse_message(bytes, m, header_len) == ipp::ParseStatus::Complete);
+    REQUIRE(header_len == header.size());
+    REQUIRE(m.code == 0x0002);
+    REQUIRE(m.request_id == 42);
+
+    const auto* name = m.find(ipp::tag::OperationAttributes, "job-name");
+    REQUIRE(name);
+    REQUIRE(name->value == "report");
+    REQUIRE(name->value.data() >= bytes.data());
+    REQUIRE(name->value.data() < bytes.data() + bytes.size());
+    REQUIRE(m.attributes.back().name == "job-name");
+    REQUIRE(m.attributes.back().value == "second-value");
+
+    REQUIRE(ipp::parse_message(std::string("\x01\x01\x00\x02\x00\x00\x00\x01\x21", 9), m, header_len)
+            == ipp::ParseStatus::Malformed);
+}
+
+TEST_CASE("IPP Print-Job streams the document into a submitted job") {
+    auto backend = std::make_shared<CaptureBackend>();
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    reg.set_payload_store(std::make_shared<PayloadStore>());
+    Scheduler sched;
+    sched.set_backend(backend);
+    sched.start();
+    IppPrinter printer(reg, sched, "ipp://localhost/ipp/print");
+
+    auto w = request(ipp::Operation::PrintJob, 1);
+    w.add(ipp::tag::NameWithoutLanguage, "job-name", "from-ipp");
+    const std::string document(100000, 'd');
+    const std::string raw = roundtrip(printer, w.finish() + document);
+    const auto resp = parse(raw);
+
+    REQUIRE(resp.code == static_cast<std::uint16_t>(ipp::StatusCode::SuccessfulOk));
+    REQUIRE(resp.request_id == 1);
+    const auto* id = resp.find(ipp::tag::JobAttributes, "job-id");
+    REQUIRE(id);
+    auto rec = reg.find_by_job_id(static_cast<JobId>(*id->integer()));
+    REQUIRE(rec);
+    REQUIRE(rec->job->name() == "from-ipp");
+    REQUIRE(rec->job->wait_terminal(2s) == JobState::Completed);
+    REQUIRE(backend->last() == document);
+
+    auto q = request(ipp::Operation::GetJobAttributes, 2);
+    q.add_integer(ipp::tag::Integer, "job-id", *id->integer());
+    const std::string raw_status = roundtrip(printer, q.finish());
+    const auto status = parse(raw_status);
+    REQUIRE(status.code == static_cast<std::uint16_t>(ipp::StatusCode::SuccessfulOk));
+    REQUIRE(status.find(ipp::tag::JobAttributes, "job-state")->integer() == 9);
+
+    sched.stop();
+}
+
+TEST_CASE("IPP Print-Job with a cut-off document creates no job") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    reg.set_payload_store(std::make_shared<PayloadStore>());
+    Scheduler sched;
+    IppPrinter printer(reg, sched, "ipp://localhost/ipp/print");
+
+    auto w = request(ipp::Operation::PrintJob, 3);
+    const std::string bytes = w.finish() + std::string(5000, 'd');
+    IppPrinter::Exchange ex(printer);
+    REQUIRE(ex.write(bytes.data(), bytes.size()));
+    ex.abort();     // the connection dropped before the body ended
+
+    const auto resp = parse(ex.finish());
+    REQUIRE(resp.code == static_cast<std::uint16_t>(ipp::StatusCode::ClientErrorBadRequest));
+    REQUIRE(reg.list().empty());
+}
+
+TEST_CASE("IPP Cancel-Job and error statuses") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    Scheduler sched;    // not started: submitted jobs stay pending
+    IppPrinter printer(reg, sched, "ipp://localhost/ipp/print");
+
+    auto pj = request(ipp::Operation::PrintJob, 1);
+    const std::string raw = roundtrip(printer, pj.finish() + "x");
+    const auto created = parse(raw);
+    const auto uri = created.find(ipp::tag::JobAttributes, "job-uri");
+    REQUIRE(uri);
+
+    auto cancel = request(ipp::Operation::CancelJob, 2);
+    cancel.add(ipp::tag::Uri, "job-uri", uri->value);
+    REQUIRE(parse(roundtrip(printer, cancel.finish())).code == static_cast<std::uint16_t>(ipp::StatusCode::SuccessfulOk));
+
+    auto again = request(ipp::Operation::CancelJob, 3);
+    again.add(ipp::tag::Uri, "job-uri", uri->value);
+    REQUIRE(parse(roundtrip(printer, again.finish())).code
+            == static_cast<std::uint16_t>(ipp::StatusCode::ClientErrorNotPossible));
+
+    auto missing = request(ipp::Operation::GetJobAttributes, 4);
+    missing.add_integer(ipp::tag::Integer, "job-id", 999999);
+    REQUIRE(parse(roundtrip(printer, missing.finish())).code
+            == static_cast<std::uint16_t>(ipp::StatusCode::ClientErrorNotFound));
+
+    REQUIRE(parse(roundtrip(printer, request(ipp::Operation::ValidateJob, 5).finish())).code
+            == static_cast<std::uint16_t>(ipp::StatusCode::SuccessfulOk));
+    REQUIRE(parse(roundtrip(printer, request(static_cast<ipp::Operation>(0x000B), 6).finish())).code
+            == static_cast<std::uint16_t>(ipp::StatusCode::ServerErrorOperationNotSupported));
+    REQUIRE(parse(roundtrip(printer, std::string("\x01\x01\x00\x02", 4))).code
+            == static_cast<std::uint16_t>(ipp::StatusCode::ClientErrorBadRequest));
+}
@@ -1,5 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 #include "printpipe/job.hpp"
+#include "printpipe/event_bus.hpp"
+#include "printpipe/file_backend.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
 
 using namespace printpipe;
 
@@ -31,3 +40,90 @@ TEST_CASE("Invalid transitions are rejected") {
     REQUIRE_FALSE(job.start_printing());
     REQUIRE(job.state() == JobState::Created);
 }
+
+TEST_CASE("Payload swaps are refused once the job has been submitted") {
+    Job job{"doc"};
+
+    REQUIRE(job.set_payload_if_created(Payload::from_string("first")));
+    REQUIRE(job.enqueue());
+    REQUIRE_FALSE(job.set_payload_if_created(Payload::from_string("late")));
+    REQUIRE(job.payload_copy() == "first");
+}
+
+TEST_CASE("No payload swap lands after enqueue() returns") {
+    for (int round = 0; round < 200; ++round) {
+        Job job{"doc"};
+        job.set_payload("initial");
+        std::atomic<bool> started{false};
+        std::thread swapper([&] {
+            started = true;
+            for (int i = 0; job.set_payload_if_created(Payload::from_string(std::to_string(i))); ++i) {
+            }
+        });
+        while (!started) std::this_thread::yield();
+
+        const bool queued = job.enqueue();
+        const std::string seen = job.payload_copy();
+        swapper.join();
+        REQUIRE(queued);
+        REQUIRE(job.payload_copy() == seen);
+    }
+}
+
+TEST_CASE("Events carry job ids and resolve names through the bus") {
+    auto bus = std::make_shared<EventBus>();
+    Job job{"doc"};
+    job.set_event_bus(bus);
+
+    REQUIRE(job.enqueue());
+    REQUIRE_FALSE(job.complete());
+
+    auto evs = bus->snapshot();
+    REQUIRE(evs.size() == 2);
+    REQUIRE(evs[0].job_id == job.id());
+    REQUIRE(evs[0].kind == EventKind::StateChanged);
+    REQUIRE(evs[1].kind == EventKind::RejectedTransition);
+    REQUIRE(evs[1].reason == ReasonCode::TransitionNotAllowed);
+    REQUIRE(bus->job_name(evs[0].job_id) == "doc");
+}
+
+TEST_CASE("Cancel trips the job's cancellation token") {
+    Job job{"doc"};
+    auto token = job.cancel_token();
+
+    REQUIRE_FALSE(token.stop_requested());
+    REQUIRE(job.enqueue());
+    REQUIRE(job.cancel());
+    REQUIRE(token.stop_requested());
+    REQUIRE(job.cancel_requested_at() <= std::chrono::steady_clock::now());
+}
+
+TEST_CASE("FileBackend abandons canceled jobs without leaving output") {
+    const auto dir = std::filesystem::temp_directory_path() / "printpipe-test-cancel";
+    FileBackend backend{dir};
+    Job job{"canceled-doc"};
+    REQUIRE(job.cancel());
+
+    REQUIRE_FALSE(backend.print(job, std::string(1 << 20, 'x')));
+    REQUIRE_FALSE(std::filesystem::exists(dir / "canceled-doc.txt"));
+}
+
+TEST_CASE("FileBackend keeps an earlier same-named document when a job is canceled") {
+    const auto dir = std::filesystem::temp_directory_path() / "printpipe-test-cancel-shared";
+    std::filesystem::remove_all(dir);
+    FileBackend backend{dir};
+
+    Job first{"report"};
+    REQUIRE(backend.print(first, "finished"));
+
+    Job second{"report"};
+    REQUIRE(second.cancel());
+    REQUIRE_FALSE(backend.print(second, std::string(1 << 20, 'x')));
+
+    std::ifstream in(dir / "report.txt");
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    REQUIRE(content == "finished");
+    // Only the finished document is left in the directory
+    REQUIRE(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator{}) == 1);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/job_registry.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace printpipe;
+
+namespace {
+void finish(const std::shared_ptr<Job>& job) {
+    (void)job->enqueue();
+    (void)job->cancel();
+}
+} // namespace
+
+TEST_CASE("Registry assigns sequential ids and finds jobs") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+
+    auto a = reg.create("a", "one");
+    auto b = reg.create("b", "two");
+
+    REQUIRE(a.id == "job-000000");
+    REQUIRE(b.id == "job-000001");
+    REQUIRE(reg.find(a.id)->job->name() == "a");
+    REQUIRE_FALSE(reg.find("job-999999"));
+    REQUIRE(reg.list().size() == 2);
+}
+
+TEST_CASE("Retention evicts oldest terminal jobs beyond the cap") {
+    auto bus = std::make_shared<EventBus>();
+    JobRegistry reg{"out", bus};
+    reg.set_retention_policy(RetentionPolicy{.max_terminal_jobs = 2});
+
+    auto first = reg.create("first", "");
+    auto second = reg.create("second", "");
+    auto third = reg.create("third", "");
+    auto running = reg.create("running", "");
+
+    finish(first.job);
+    finish(second.job);
+    finish(third.job);
+    REQUIRE(running.job->enqueue());
+
+    REQUIRE(reg.sweep() == 1);
+    REQUIRE_FALSE(reg.find(first.id));
+    REQUIRE(reg.find(second.id));
+    REQUIRE(reg.find(running.id));
+    REQUIRE(reg.size() == 3);
+
+    // The evicted job's events and name go with it
+    for (const auto& ev : bus->snapshot()) REQUIRE(ev.job_id != first.job->id());
+    REQUIRE(bus->job_name(first.job->id()).empty());
+}
+
+TEST_CASE("Retention by byte budget and age") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    auto big = reg.create("big", std::string(4096, 'x'));
+    finish(big.job);
+
+    reg.set_retention_policy(RetentionPolicy{.max_bytes = 1024});
+    REQUIRE(reg.sweep() == 1);
+    REQUIRE(reg.retained_bytes() == 0);
+
+    auto old = reg.create("old", "");
+    finish(old.job);
+    reg.set_retention_policy(RetentionPolicy{.max_age = std::chrono::seconds(3600)});
+    REQUIRE(reg.sweep() == 0);
+    reg.set_retention_policy(RetentionPolicy{.max_age = std::chrono::nanoseconds(1)});
+    REQUIRE(reg.sweep() == 1);
+    REQUIRE(reg.size() == 0);
+}
+
+TEST_CASE("Evicting a job keeps output a newer same-named job still owns") {
+    const auto dir = std::filesystem::temp_directory_path() / "printpipe-test-registry-output";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    JobRegistry reg{dir, std::make_shared<EventBus>()};
+    reg.set_retention_policy(RetentionPolicy{.max_terminal_jobs = 1, .delete_output_files = true});
+
+    auto older = reg.create("report", "");
+    auto newer = reg.create("report", "");
+    REQUIRE(older.output_file == newer.output_file);
+    std::ofstream(newer.output_file) << "newer";
+
+    finish(older.job);
+    finish(newer.job);
+    REQUIRE(reg.sweep() == 1);
+    REQUIRE_FALSE(reg.find(older.id));
+    REQUIRE(std::filesystem::exists(newer.output_file));
+
+    // Once the last job writing it goes, the file goes too
+    reg.set_retention_policy(RetentionPolicy{.max_terminal_jobs = 0, .max_bytes = 1,
+                                             .delete_output_files = true});
+    REQUIRE(reg.sweep() == 1);
+    REQUIRE_FALSE(std::filesystem::exists(newer.output_file));
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Timer sweeps enforce max age without requests") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    reg.set_retention_policy(RetentionPolicy{.max_age = std::chrono::milliseconds(1)});
+    auto done = reg.create("done", "");
+    finish(done.job);
+
+    reg.sweep_every(std::chrono::milliseconds(5));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (reg.size() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    REQUIRE(reg.size() == 0);
+}
+
+TEST_CASE("Event log reclaims retired jobs behind a long-lived one") {
+    auto bus = std::make_shared<EventBus>();
+    JobRegistry reg{"out", bus};
+    reg.set_retention_policy(RetentionPolicy{.max_terminal_jobs = 1});
+
+    auto pinned = reg.create("pinned", "");
+    REQUIRE(pinned.job->enqueue());         // first in the log, never finishes
+
+    std::shared_ptr<Job> late;
+    for (int i = 0; i < 2000; ++i) {
+        auto rec = reg.create("short", "");
+        finish(rec.job);
+        if (i == 0) late = rec.job;
+        reg.sweep();
+    }
+    // Two events per finished job; only the retained one's and the pinned job's remain
+    REQUIRE(bus->size() < 1500);
+
+    // A rejected transition on an evicted job is not logged again
+    const auto before = bus->size();
+    REQUIRE_FALSE(late->start_printing());
+    REQUIRE(bus->size() == before);
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/json_writer.hpp"
+
+using namespace printpipe;
+
+namespace {
+
+std::string status(bool pretty) {
+    std::string out;
+    JsonWriter w(out, pretty);
+    w.begin_array();
+    w.begin_object()
+        .field("job_id", "job-000001")
+        .field("attempts", 2)
+        .field("ok", true);
+    w.key("tags").begin_array().end_array();
+    w.key("meta").begin_object().field("ratio", 0.5).key("none").null().end_object();
+    w.end_object();
+    w.end_array();
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("JsonWriter writes compact output by default") {
+    REQUIRE(status(false) ==
+            R"([{"job_id":"job-000001","attempts":2,"ok":true,"tags":[],"meta":{"ratio":0.5,"none":null}}])");
+}
+
+TEST_CASE("JsonWriter pretty output matches two-space dump formatting") {
+    REQUIRE(status(true) ==
+            "[\n"
+            "  {\n"
+            "    \"job_id\": \"job-000001\",\n"
+            "    \"attempts\": 2,\n"
+            "    \"ok\": true,\n"
+            "    \"tags\": [],\n"
+            "    \"meta\": {\n"
+            "      \"ratio\": 0.5,\n"
+            "      \"none\": null\n"
+            "    }\n"
+            "  }\n"
+            "]");
+
+    std::string empty;
+    JsonWriter(empty, true).begin_object().end_object();
+    REQUIRE(empty == "{}");
+}
+
+TEST_CASE("JsonWriter escapes strings and appends to existing content") {
+    std::string out = "prefix:";
+    JsonWriter w(out);
+    w.begin_object()
+        .field("quote\"key", std::string_view("a\\b\n\t\x01/\xc3\xa9"))
+        .field("n", std::uint64_t{18446744073709551615u})
+        .field("neg", std::int64_t{-42})
+        .end_object();
+    REQUIRE(out == "prefix:{\"quote\\\"key\":\"a\\\\b\\n\\t\\u0001/\xc3\xa9\",\"n\":18446744073709551615,\"neg\":-42}");
+}
+
+TEST_CASE("JsonWriter replaces invalid UTF-8 like nlohmann's replace handler") {
+    auto write = [](std::string_view s) {
+        std::string out;
+        JsonWriter(out).value(s);
+        return out;
+    };
+    const std::string fffd = "\xef\xbf\xbd";
+
+    REQUIRE(write("\xf0\x9f\x96\xa8 ok") == "\"\xf0\x9f\x96\xa8 ok\"");
+    REQUIRE(write("a\xff" "b") == "\"a" + fffd + "b\"");
+    REQUIRE(write("\xc3(") == "\"" + fffd + "(\"");                  // offending byte kept
+    REQUIRE(write("x\xe2\x82") == "\"x" + fffd + "\"");              // truncated at the end
+    REQUIRE(write("\xed\xa0\x80") == "\"" + fffd + fffd + fffd + "\"");  // surrogate
+    REQUIRE(write("\xc0\xaf\n") == "\"" + fffd + fffd + "\\n\"");   // overlong
+}
@@ -0,0 +1,213 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/job_registry.hpp"
+#include "printpipe/local_submit.hpp"
+#include "printpipe/scheduler.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <mutex>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+namespace {
+
+class CaptureBackend final : public IBackend {
+public:
+    bool print(const Job&, std::string_view payload) override {
+        std::lock_guard<std::mutex> lk(mu_);
+        printed_.emplace_back(payload);
+        return true;
+    }
+
+    std::vector<std::string> printed() {
+        std::lock_guard<std::mutex> lk(mu_);
+        return printed_;
+    }
+
+private:
+    std::mutex mu_;
+    std::vector<std::string> printed_;
+};
+
+std::filesystem::path socket_path() {
+    return std::filesystem::temp_directory_path() / ("printpipe-test-" + std::to_string(::getpid()) + ".sock");
+}
+
+} // namespace
+
+TEST_CASE("Local socket submits inline payloads and waits for completion") {
+    auto backend = std::make_shared<CaptureBackend>();
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    Scheduler sched;
+    sched.set_backend(backend);
+    sched.start();
+
+    LocalSubmitServer server{socket_path(), reg, sched};
+    REQUIRE(server.start());
+
+    LocalSubmitClient client;
+    REQUIRE(client.connect(server.socket_path()));
+
+    auto id = client.submit("inline", "hello over uds");
+    REQUIRE(id);
+    REQUIRE(client.wait(*id, 2s) == JobState::Completed);
+    REQUIRE(client.status(*id) == JobState::Completed);
+    REQUIRE(reg.find(*id)->job->name() == "inline");
+    REQUIRE(backend->printed() == std::vector<std::string>{"hello over uds"});
+
+    server.stop();
+    sched.stop();
+}
+
+TEST_CASE("Local socket is private to the server's user by default") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    Scheduler sched;
+    namespace fs = std::filesystem;
+
+    LocalSubmitServer server{socket_path(), reg, sched};
+    REQUIRE(server.start());
+    REQUIRE((fs::status(server.socket_path()).permissions() & fs::perms::all) ==
+            (fs::perms::owner_read | fs::perms::owner_write));
+    server.stop();
+
+    LocalSubmitServer shared{socket_path(), reg, sched};
+    shared.set_socket_permissions(fs::perms::owner_read | fs::perms::owner_write |
+                                  fs::perms::group_read | fs::perms::group_write);
+    REQUIRE(shared.start());
+    REQUIRE((fs::status(shared.socket_path()).permissions() & fs::perms::all) ==
+            (fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read | fs::perms::group_write));
+    shared.stop();
+}
+
+TEST_CASE("Local socket maps documents passed as file descriptors") {
+    auto backend = std::make_shared<CaptureBackend>();
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    Scheduler sched;
+    sched.set_backend(backend);
+    sched.start();
+
+    LocalSubmitServer server{socket_path(), reg, sched};
+    REQUIRE(server.start());
+
+    const std::string doc(200000, 'x');
+    int mfd = ::memfd_create("printpipe-test", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    REQUIRE(mfd >= 0);
+    REQUIRE(::write(mfd, doc.data(), doc.size()) == static_cast<ssize_t>(doc.size()));
+    REQUIRE(::fcntl(mfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE) == 0);
+
+    LocalSubmitClient client;
+    REQUIRE(client.connect(server.socket_path()));
+    auto id = client.submit_fd("memfd", mfd);
+    ::close(mfd);
+    REQUIRE(id);
+    REQUIRE(client.wait(*id, 2s) == JobState::Completed);
+    REQUIRE(reg.find(*id)->job->payload()->mapped());
+    REQUIRE(backend->printed().size() == 1);
+    REQUIRE(backend->printed().front() == doc);
+
+    server.stop();
+    sched.stop();
+}
+
+TEST_CASE("Local socket copies unsealed files and rejects pipes") {
+    auto backend = std::make_shared<CaptureBackend>();
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    Scheduler sched;
+    sched.set_backend(backend);
+    sched.start();
+
+    LocalSubmitServer server{socket_path(), reg, sched};
+    REQUIRE(server.start());
+    LocalSubmitClient client;
+    REQUIRE(client.connect(server.socket_path()));
+
+    int mfd = ::memfd_create("printpipe-test", MFD_CLOEXEC);
+    REQUIRE(mfd >= 0);
+    REQUIRE(::write(mfd, "unsealed", 8) == 8);
+    auto id = client.submit_fd("copied", mfd);
+    REQUIRE(id);
+    // Rewriting the file after submit must not change the job
+    REQUIRE(::pwrite(mfd, "REWRITE!", 8, 0) == 8);
+    REQUIRE(::ftruncate(mfd, 0) == 0);
+    ::close(mfd);
+    REQUIRE(client.wait(*id, 2s) == JobState::Completed);
+    REQUIRE_FALSE(reg.find(*id)->job->payload()->mapped());
+    REQUIRE(backend->printed() == std::vector<std::string>{"unsealed"});
+
+    int pipe_fds[2];
+    REQUIRE(::pipe(pipe_fds) == 0);
+    REQUIRE_FALSE(client.submit_fd("pipe", pipe_fds[0]));
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+    // The connection stays usable after a rejected descriptor
+    REQUIRE(client.status(*id) == JobState::Completed);
+
+    server.stop();
+    sched.stop();
+}
+
+TEST_CASE("Local socket rejects requests carrying several descriptors") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    Scheduler sched;
+
+    LocalSubmitServer server{socket_path(), reg, sched};
+    REQUIRE(server.start());
+
+    int sock = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    REQUIRE(sock >= 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, server.socket_path().c_str());
+    REQUIRE(::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    // CreateSubmit, name "x", fd mode, with two descriptors attached
+    const unsigned char frame[] = {5, 0, 0, 0, 1, 1, 0, 'x', 1};
+    iovec iov{const_cast<unsigned char*>(frame), sizeof(frame)};
+    int fds[2] = {::memfd_create("a", MFD_CLOEXEC), ::memfd_create("b", MFD_CLOEXEC)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(c), fds, sizeof(fds));
+    REQUIRE(::sendmsg(sock, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(frame)));
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    unsigned char hdr[5];
+    REQUIRE(::recv(sock, hdr, sizeof(hdr), MSG_WAITALL) == 5);
+    REQUIRE(hdr[4] == static_cast<unsigned char>(local_proto::Status::BadRequest));
+    REQUIRE(reg.list().empty());
+    ::close(sock);
+
+    server.stop();
+}
+
+TEST_CASE("Local socket reports unknown jobs and wait timeouts") {
+    JobRegistry reg{"out", std::make_shared<EventBus>()};
+    Scheduler sched;    // never started: jobs stay queued
+
+    LocalSubmitServer server{socket_path(), reg, sched};
+    REQUIRE(server.start());
+
+    LocalSubmitClient client;
+    REQUIRE(client.connect(server.socket_path()));
+    REQUIRE_FALSE(client.status("job-999999"));
+
+    auto id = client.submit("stuck", "x");
+    REQUIRE(id);
+    REQUIRE(client.wait(*id, 20ms) == JobState::Created);
+
+    server.stop();
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/log.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace printpipe;
+
+namespace {
+
+// The logger is process-wide: capture into a temp file, then restore.
+class Capture {
+public:
+    Capture() : file_(std::tmpfile()) { log::set_sink(file_); }
+    ~Capture() {
+        log::set_sink(stdout);
+        log::set_level(log::Level::Info);
+        log::set_rate_limit(0);
+        std::fclose(file_);
+    }
+
+    std::string text() {
+        log::flush();
+        std::fflush(file_);
+        std::rewind(file_);
+        std::string out;
+        char buf[4096];
+        std::size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), file_)) > 0) out.append(buf, n);
+        return out;
+    }
+
+private:
+    std::FILE* file_;
+};
+
+std::size_t count(const std::string& text, const std::string& needle) {
+    std::size_t n = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+} // namespace
+
+TEST_CASE("Logger filters by level and formats records") {
+    Capture cap;
+    log::set_level(log::Level::Warn);
+    PRINTPIPE_LOG_INFO("hidden %d", 1);
+    PRINTPIPE_LOG_WARN("shown %d", 2);
+    PRINTPIPE_LOG_ERROR("job %s failed", "job-000007");
+
+    const auto text = cap.text();
+    REQUIRE(count(text, "hidden") == 0);
+    REQUIRE(count(text, "WARN  shown 2\n") == 1);
+    REQUIRE(count(text, "ERROR job job-000007 failed\n") == 1);
+    REQUIRE(text.find('Z') != std::string::npos);   // UTC timestamp prefix
+}
+
+TEST_CASE("Logger truncates long messages") {
+    Capture cap;
+    const std::string big(1000, 'x');
+    PRINTPIPE_LOG_INFO("%s", big.c_str());
+    REQUIRE(count(cap.text(), std::string(log::kMaxMessage - 1, 'x') + "\n") == 1);
+}
+
+TEST_CASE("Logger rate limit drops and counts records below error") {
+    Capture cap;
+    log::set_rate_limit(5);
+    const auto before = log::stats();
+    for (int i = 0; i < 50; ++i) PRINTPIPE_LOG_INFO("burst %d", i);
+    PRINTPIPE_LOG_ERROR("always");
+
+    const auto text = cap.text();
+    const auto after = log::stats();
+    // A second boundary mid-burst can admit one extra window's worth
+    REQUIRE(count(text, "burst") <= 10);
+    REQUIRE(after.dropped_rate - before.dropped_rate >= 40);
+    REQUIRE(count(text, "ERROR always") == 1);
+    REQUIRE(count(text, "[log] dropped") >= 1);
+}
+
+TEST_CASE("Concurrent writers lose nothing when the queue keeps up") {
+    Capture cap;
+    const auto before = log::stats();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 500; ++i) {
+                PRINTPIPE_LOG_INFO("t%d n%d", t, i);
+                if (i % 100 == 99) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    const auto text = cap.text();
+    const auto after = log::stats();
+    const auto dropped = after.dropped_full - before.dropped_full;
+    REQUIRE(after.written - before.written + dropped == 2000);
+    REQUIRE(count(text, " n") + dropped == 2000);
+}
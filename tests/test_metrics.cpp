@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/event_bus.hpp"
+#include "printpipe/metrics.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+namespace {
+
+bool contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+} // namespace
+
+TEST_CASE("Histogram buckets are cumulative and render in Prometheus format") {
+    MetricsRegistry m;
+    auto& h = m.histogram("latency_seconds", "Test latency", "op=\"x\"", {0.1, 1.0});
+    h.observe(0.05);
+    h.observe(0.1);
+    h.observe(0.5);
+    h.observe(std::chrono::nanoseconds(5s));
+
+    const auto snap = h.snapshot();
+    REQUIRE(snap.cumulative == std::vector<std::uint64_t>{2, 3, 4});
+
+    m.counter("requests_total", "Requests").inc(3);
+    REQUIRE(&m.counter("requests_total", "Requests") == &m.counter("requests_total", "Requests"));
+
+    const auto text = m.render();
+    REQUIRE(contains(text, "# TYPE latency_seconds histogram\n"));
+    REQUIRE(contains(text, "latency_seconds_bucket{op=\"x\",le=\"0.1\"} 2\n"));
+    REQUIRE(contains(text, "latency_seconds_bucket{op=\"x\",le=\"+Inf\"} 4\n"));
+    REQUIRE(contains(text, "latency_seconds_count{op=\"x\"} 4\n"));
+    REQUIRE(contains(text, "# TYPE requests_total counter\nrequests_total 3\n"));
+}
+
+TEST_CASE("Counters stay exact under concurrent recording") {
+    MetricsRegistry m;
+    auto& c = m.counter("hits_total", "Hits");
+    auto& h = m.histogram("work_seconds", "Work");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                c.inc();
+                h.observe(std::chrono::microseconds(i));
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    REQUIRE(c.value() == 40000);
+    REQUIRE(h.snapshot().cumulative.back() == 40000);
+}
+
+TEST_CASE("Job metrics track states and stage latency from events") {
+    auto bus = std::make_shared<EventBus>();
+    auto metrics = std::make_shared<MetricsRegistry>();
+    std::uint64_t created = 0;
+    auto jm = JobMetrics::attach(metrics, *bus, [&] { return created; });
+
+    auto job = std::make_shared<Job>("m");
+    job->set_event_bus(bus);
+    ++created;
+    REQUIRE(jm->in_state(JobState::Created, created) == 1);
+
+    std::this_thread::sleep_for(2ms);
+    REQUIRE(job->enqueue());
+    REQUIRE(jm->in_state(JobState::Created, created) == 0);
+    REQUIRE(jm->in_state(JobState::Queued, created) == 1);
+
+    REQUIRE(job->cancel());
+    REQUIRE(jm->in_state(JobState::Queued, created) == 0);
+    REQUIRE(jm->in_state(JobState::Canceled, created) == 1);
+
+    auto& created_stage = metrics->histogram("printpipe_job_stage_seconds", "", "stage=\"created\"");
+    const auto snap = created_stage.snapshot();
+    REQUIRE(snap.cumulative.back() == 1);
+    REQUIRE(snap.sum >= 0.002);
+
+    const auto text = metrics->render();
+    REQUIRE(contains(text, "printpipe_jobs{state=\"canceled\"} 1\n"));
+    REQUIRE(contains(text, "printpipe_job_stage_seconds_count{stage=\"queued\"} 1\n"));
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/payload.hpp"
+
+#include <filesystem>
+
+using namespace printpipe;
+
+namespace {
+PayloadStoreConfig test_config() {
+    PayloadStoreConfig cfg;
+    cfg.spill_threshold = 64;
+    cfg.max_resident_bytes = 100;
+    cfg.spool_dir = std::filesystem::temp_directory_path() / "printpipe-test-spool";
+    return cfg;
+}
+} // namespace
+
+TEST_CASE("Small payloads stay resident and are accounted") {
+    PayloadStore store{test_config()};
+
+    auto p = store.store("hello");
+    REQUIRE_FALSE(p->spilled());
+    REQUIRE(store.resident_bytes() == 5);
+    REQUIRE(p->view().data() == "hello");
+
+    p.reset();
+    REQUIRE(store.resident_bytes() == 0);
+}
+
+TEST_CASE("Large payloads spill to disk and map back on read") {
+    PayloadStore store{test_config()};
+    const std::string big(4096, 'z');
+
+    auto p = store.store(big);
+    REQUIRE(p->spilled());
+    REQUIRE(p->size() == big.size());
+    REQUIRE(p->resident_bytes() == 0);
+    REQUIRE(store.resident_bytes() == 0);
+
+    {
+        auto view = p->view();
+        REQUIRE(view.valid());
+        REQUIRE(view.data() == big);
+    }
+
+    REQUIRE(std::distance(std::filesystem::directory_iterator(store.config().spool_dir),
+                          std::filesystem::directory_iterator{}) == 1);
+    p.reset();
+    REQUIRE(std::filesystem::is_empty(store.config().spool_dir));
+}
+
+TEST_CASE("Resident cap forces spilling of otherwise small payloads") {
+    PayloadStore store{test_config()};
+
+    auto a = store.store(std::string(60, 'a'));
+    auto b = store.store(std::string(60, 'b'));
+
+    REQUIRE_FALSE(a->spilled());
+    REQUIRE(b->spilled());
+    REQUIRE(store.resident_bytes() == 60);
+}
+
+TEST_CASE("Writer streams chunks and spills once past the threshold") {
+    PayloadStore store{test_config()};
+
+    auto small = store.writer();
+    REQUIRE(small.append("abc", 3));
+    REQUIRE(small.append("def", 3));
+    auto p = small.finish();
+    REQUIRE(p);
+    REQUIRE_FALSE(p->spilled());
+    REQUIRE(p->view().data() == "abcdef");
+
+    auto big = store.writer();
+    std::string expected;
+    for (int i = 0; i < 10; ++i) {
+        const std::string chunk(20, static_cast<char>('a' + i));
+        REQUIRE(big.append(chunk.data(), chunk.size()));
+        expected += chunk;
+    }
+    auto q = big.finish();
+    REQUIRE(q);
+    REQUIRE(q->spilled());
+    REQUIRE(q->size() == expected.size());
+    REQUIRE(q->view().data() == expected);
+}
+
+TEST_CASE("Spool directory and files are private to the user") {
+    auto cfg = test_config();
+    cfg.spool_dir = std::filesystem::temp_directory_path() / "printpipe-test-spool-perms";
+    std::filesystem::remove_all(cfg.spool_dir);
+    std::filesystem::create_directories(cfg.spool_dir);
+    std::filesystem::permissions(cfg.spool_dir, std::filesystem::perms::all);  // as if planted 0777
+    PayloadStore store{cfg};
+
+    auto p = store.store(std::string(4096, 's'));
+    REQUIRE(p->spilled());
+    using std::filesystem::perms;
+    REQUIRE((std::filesystem::status(cfg.spool_dir).permissions() & perms::all) == perms::owner_all);
+
+    const auto file = std::filesystem::directory_iterator(cfg.spool_dir)->path();
+    REQUIRE((std::filesystem::status(file).permissions() & perms::all) == (perms::owner_read | perms::owner_write));
+
+    p.reset();
+    std::filesystem::remove_all(cfg.spool_dir);
+}
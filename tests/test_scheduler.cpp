@@ -0,0 +1,183 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/scheduler.hpp"
+
+#include <thread>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+namespace {
+
+class FlakyBackend final : public IBackend {
+public:
+    explicit FlakyBackend(int failures) : failures_(failures) {}
+
+    bool print(const Job&, std::string_view) override {
+        calls_.fetch_add(1);
+        return failures_.fetch_sub(1) <= 0;
+    }
+
+    int calls() const { return calls_.load(); }
+
+private:
+    std::atomic<int> failures_;
+    std::atomic<int> calls_{0};
+};
+
+void wait_terminal(const Job& job) {
+    for (int i = 0; i < 2000 && !Job::is_terminal(job.state()); ++i) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Scheduler retries failed prints with backoff") {
+    auto backend = std::make_shared<FlakyBackend>(2);
+    Scheduler sched;
+    sched.set_backend(backend);
+    sched.set_retry_policy(RetryPolicy{.max_attempts = 3, .initial_backoff = 5ms, .jitter = 0.0});
+    sched.start();
+
+    auto job = std::make_shared<Job>("flaky");
+    REQUIRE(sched.submit(job));
+    wait_terminal(*job);
+
+    REQUIRE(job->state() == JobState::Completed);
+    REQUIRE(job->attempts() == 3);
+    REQUIRE(backend->calls() == 3);
+    REQUIRE(sched.stats().retries_scheduled == 2);
+}
+
+TEST_CASE("Scheduler reports cancel-to-release latency to its observer") {
+    Scheduler sched;
+    sched.set_backend(std::make_shared<FlakyBackend>(0));
+    std::atomic<int> observed{0};
+    sched.set_cancel_release_observer([&](std::chrono::nanoseconds d) {
+        if (d.count() >= 0) observed.fetch_add(1);
+    });
+
+    auto job = std::make_shared<Job>("canceled");
+    REQUIRE(sched.submit(job));
+    REQUIRE(job->cancel());
+    sched.start();
+    for (int i = 0; i < 2000 && observed.load() == 0; ++i) std::this_thread::sleep_for(1ms);
+    sched.stop();
+
+    REQUIRE(observed.load() == 1);
+    REQUIRE(sched.stats().cancel_releases == 1);
+}
+
+TEST_CASE("Scheduler fails the job once retries are exhausted") {
+    auto backend = std::make_shared<FlakyBackend>(100);
+    Scheduler sched;
+    sched.set_backend(backend);
+    sched.start();
+
+    auto job = std::make_shared<Job>("broken");
+    job->set_retry_policy(RetryPolicy{.max_attempts = 2, .initial_backoff = 1ms});
+    REQUIRE(sched.submit(job));
+    wait_terminal(*job);
+
+    REQUIRE(job->state() == JobState::Failed);
+    REQUIRE(job->attempts() == 2);
+}
+
+namespace {
+
+class BatchRecorder final : public IBackend {
+public:
+    bool print(const Job&, std::string_view) override {
+        singles.fetch_add(1);
+        return true;
+    }
+
+    void print_batch(std::span<PrintItem> items) override {
+        batches.fetch_add(1);
+        for (auto& item : items) item.ok = item.job->name() != "bad";
+    }
+
+    std::atomic<int> singles{0};
+    std::atomic<int> batches{0};
+};
+
+} // namespace
+
+TEST_CASE("Scheduler coalesces queued small jobs into one batch") {
+    auto backend = std::make_shared<BatchRecorder>();
+    Scheduler sched;
+    sched.set_backend(backend);
+    sched.set_coalescing(CoalescingPolicy{.enabled = true, .max_job_bytes = 16, .max_batch_jobs = 8});
+
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int i = 0; i < 8; ++i) {
+        auto job = std::make_shared<Job>(i == 3 ? "bad" : "label");
+        job->set_payload("tiny");
+        jobs.push_back(job);
+        REQUIRE(sched.submit(job));
+    }
+    auto big = std::make_shared<Job>("big");
+    big->set_payload(std::string(64, 'x'));
+    REQUIRE(sched.submit(big));
+
+    sched.start();
+    for (const auto& job : jobs) wait_terminal(*job);
+    wait_terminal(*big);
+
+    REQUIRE(backend->batches == 1);
+    REQUIRE(backend->singles == 1);
+    REQUIRE(sched.stats().batched_jobs == 8);
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(jobs[i]->state() == (i == 3 ? JobState::Failed : JobState::Completed));
+    }
+    REQUIRE(big->state() == JobState::Completed);
+}
+
+namespace {
+
+// Print time depends on document size: small ones are slow, large instant.
+class SizedBackend final : public IBackend {
+public:
+    bool print(const Job&, std::string_view payload) override {
+        if (payload.size() <= 16) std::this_thread::sleep_for(500ms);
+        else if (payload.size() <= 32) std::this_thread::sleep_for(50ms);
+        return true;
+    }
+};
+
+std::shared_ptr<Job> sized_job(std::size_t bytes) {
+    auto job = std::make_shared<Job>("label");
+    job->set_payload(std::string(bytes, 'x'));
+    return job;
+}
+
+} // namespace
+
+TEST_CASE("Scheduler hands a job the batch can't take to an idle worker") {
+    Scheduler sched{2};
+    sched.set_backend(std::make_shared<SizedBackend>());
+    sched.set_coalescing(CoalescingPolicy{.enabled = true, .max_job_bytes = 16, .window = 300ms});
+    sched.start();
+    std::this_thread::sleep_for(20ms);
+
+    // One worker holds a batch open for the small job; the other prints
+    // the medium one and goes back to waiting behind it
+    auto small = sized_job(4);
+    REQUIRE(sched.submit(small));
+    std::this_thread::sleep_for(20ms);
+    auto medium = sized_job(32);
+    REQUIRE(sched.submit(medium));
+    wait_terminal(*medium);
+    std::this_thread::sleep_for(20ms);
+
+    // The big job can't join the batch and must not wait for it to print
+    auto big = sized_job(64);
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(sched.submit(big));
+    wait_terminal(*big);
+
+    REQUIRE(big->state() == JobState::Completed);
+    REQUIRE(std::chrono::steady_clock::now() - start < 250ms);
+    wait_terminal(*small);
+    REQUIRE(small->state() == JobState::Completed);
+}
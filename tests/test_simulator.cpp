@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/simulator.hpp"
+
+#include <sstream>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+namespace {
+
+double seconds(std::chrono::nanoseconds d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+} // namespace
+
+TEST_CASE("Simulation is deterministic for a given seed") {
+    sim::Config config;
+    config.workers = 2;
+    config.spool = sim::Distribution::uniform(1ms, 3ms);
+    config.print = sim::Distribution::lognormal(8ms, 0.6);
+    config.failure_rate = 0.1;
+    config.retry.max_attempts = 3;
+    config.seed = 42;
+    const auto arrivals = sim::poisson_arrivals(150, 5000, 512, 7);
+
+    const auto a = sim::simulate(config, arrivals);
+    const auto b = sim::simulate(config, arrivals);
+    REQUIRE(a.completed + a.failed == 5000);
+    REQUIRE(a.completed == b.completed);
+    REQUIRE(a.attempts == b.attempts);
+    REQUIRE(a.makespan == b.makespan);
+    REQUIRE(a.queue_delay.p99 == b.queue_delay.p99);
+    REQUIRE(a.sojourn.max == b.sojourn.max);
+
+    config.seed = 43;
+    REQUIRE(sim::simulate(config, arrivals).makespan != a.makespan);
+}
+
+TEST_CASE("Single worker with exponential service matches M/M/1") {
+    // lambda = 50/s, mu = 100/s: utilization 0.5, mean time in system 20 ms
+    sim::Config config;
+    config.print = sim::Distribution::exponential(10ms);
+    const auto report = sim::simulate(config, sim::poisson_arrivals(50, 40000, 0, 1));
+
+    REQUIRE(report.completed == 40000);
+    REQUIRE(report.utilization > 0.46);
+    REQUIRE(report.utilization < 0.54);
+    REQUIRE(seconds(report.sojourn.mean) > 0.017);
+    REQUIRE(seconds(report.sojourn.mean) < 0.023);
+    REQUIRE(report.throughput > 47);
+    REQUIRE(report.throughput < 53);
+}
+
+TEST_CASE("More workers cut queueing delay under heavy load") {
+    sim::Config config;
+    config.print = sim::Distribution::constant(10ms);
+    const auto arrivals = sim::poisson_arrivals(90, 5000, 0, 3);
+
+    const auto one = sim::simulate(config, arrivals);
+    config.workers = 2;
+    const auto two = sim::simulate(config, arrivals);
+    REQUIRE(one.queue_delay.mean > two.queue_delay.mean * 5);
+    REQUIRE(two.utilization < one.utilization);
+}
+
+TEST_CASE("Simulated failures go through the scheduler's retry policy") {
+    sim::Config config;
+    config.print = sim::Distribution::constant(1ms);
+    config.failure_rate = 0.5;
+    config.retry.max_attempts = 3;
+    config.retry.initial_backoff = 100ms;
+    const auto report = sim::simulate(config, sim::poisson_arrivals(20, 4000, 0, 5));
+
+    REQUIRE(report.completed + report.failed == 4000);
+    // Each job fails every attempt with probability 1/8 and makes 1.75 attempts on average
+    REQUIRE(report.failed > 400);
+    REQUIRE(report.failed < 600);
+    REQUIRE(report.attempts > 6600);
+    REQUIRE(report.attempts < 7400);
+    REQUIRE(report.sojourn.max >= 300ms);
+}
+
+TEST_CASE("Coalescing batches share the backend setup cost") {
+    sim::Config config;
+    config.print_setup = sim::Distribution::constant(20ms);
+    config.print = sim::Distribution::constant(1ms);
+    const auto arrivals = sim::poisson_arrivals(100, 2000, 1024, 9);
+
+    const auto single = sim::simulate(config, arrivals);
+    config.coalescing.enabled = true;
+    const auto batched = sim::simulate(config, arrivals);
+    REQUIRE(single.batches == 2000);
+    REQUIRE(batched.batches < 1000);
+    REQUIRE(batched.sojourn.p99 < single.sojourn.p99);
+}
+
+TEST_CASE("Arrival traces load from CSV") {
+    std::istringstream csv("time_s,payload_bytes\n# comment\n0.5,100\n\n0.25\n1e0, 7\n");
+    std::vector<sim::Arrival> arrivals;
+    std::string error;
+    REQUIRE(sim::load_csv(csv, arrivals, error));
+    REQUIRE(arrivals.size() == 3);
+    REQUIRE(arrivals[0].at == 250ms);
+    REQUIRE(arrivals[0].payload_bytes == 0);
+    REQUIRE(arrivals[1].payload_bytes == 100);
+    REQUIRE(arrivals[2].at == 1s);
+
+    std::istringstream bad("0.1\nsoon\n");
+    arrivals.clear();
+    REQUIRE_FALSE(sim::load_csv(bad, arrivals, error));
+    REQUIRE(error == "line 2: bad time 'soon'");
+}
+
+TEST_CASE("Service-time distributions parse from specs") {
+    REQUIRE(sim::Distribution::parse("const:5ms")->mean() == 5ms);
+    REQUIRE(sim::Distribution::parse("exp:250us")->mean() == 250us);
+    REQUIRE(sim::Distribution::parse("uniform:1ms:3ms")->mean() == 2ms);
+    REQUIRE(sim::Distribution::parse("lognormal:10ms:0")->mean() == 10ms);
+    REQUIRE_FALSE(sim::Distribution::parse("exp"));
+    REQUIRE_FALSE(sim::Distribution::parse("const:5 parsecs"));
+    REQUIRE_FALSE(sim::Distribution::parse("gamma:1ms"));
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/job.hpp"
+#include "printpipe/socket_backend.hpp"
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace printpipe;
+
+namespace {
+
+// Stand-in for a raw-socket printer: accepts connections and records
+// everything it receives. Can be told to hang up after each document, or
+// to pause between reads like a device that drains its input slowly.
+class TcpSink {
+public:
+    explicit TcpSink(bool close_after_read = false,
+                     std::chrono::milliseconds read_pause = std::chrono::milliseconds::zero())
+        : close_after_read_(close_after_read), read_pause_(read_pause) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 8);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~TcpSink() {
+        stop_ = true;
+        thread_.join();
+        ::close(listen_fd_);
+    }
+
+    std::uint16_t port() const { return port_; }
+
+    std::string received() {
+        std::lock_guard<std::mutex> lk(mu_);
+        return data_;
+    }
+
+    int accepted() const { return accepted_.load(); }
+
+private:
+    void run() {
+        std::vector<pollfd> fds{{listen_fd_, POLLIN, 0}};
+        while (!stop_) {
+            if (::poll(fds.data(), fds.size(), 10) <= 0) continue;
+            if (fds[0].revents & POLLIN) {
+                int c = ::accept(listen_fd_, nullptr, nullptr);
+                if (c >= 0) {
+                    ++accepted_;
+                    fds.push_back({c, POLLIN, 0});
+                }
+            }
+            for (std::size_t i = 1; i < fds.size(); ++i) {
+                if (!(fds[i].revents & (POLLIN | POLLHUP))) continue;
+                char buf[1 << 16];
+                const ssize_t n = ::read(fds[i].fd, buf, sizeof(buf));
+                if (n > 0) {
+                    std::lock_guard<std::mutex> lk(mu_);
+                    data_.append(buf, static_cast<std::size_t>(n));
+                }
+                if (n <= 0 || close_after_read_) {
+                    ::close(fds[i].fd);
+                    fds.erase(fds.begin() + static_cast<std::ptrdiff_t>(i--));
+                }
+            }
+            if (read_pause_.count() > 0) std::this_thread::sleep_for(read_pause_);
+        }
+        for (std::size_t i = 1; i < fds.size(); ++i) ::close(fds[i].fd);
+    }
+
+    bool close_after_read_;
+    std::chrono::milliseconds read_pause_;
+    int listen_fd_ = -1;
+    std::uint16_t port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> accepted_{0};
+    std::mutex mu_;
+    std::string data_;
+    std::thread thread_;
+};
+
+void wait_for(TcpSink& sink, std::size_t bytes) {
+    for (int i = 0; i < 500 && sink.received().size() < bytes; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Socket backend streams documents over one pooled connection") {
+    TcpSink sink;
+    SocketBackendOptions opts;
+    opts.port = sink.port();
+    opts.preamble = "<";
+    opts.trailer = ">";
+    SocketBackend backend{opts};
+    Job job{"label"};
+
+    REQUIRE(backend.print(job, "first"));
+    REQUIRE(backend.print(job, "second"));
+    wait_for(sink, 15);
+
+    REQUIRE(sink.received() == "<first><second>");
+    REQUIRE(sink.accepted() == 1);
+    REQUIRE(backend.stats().connects == 1);
+    REQUIRE(backend.stats().reuses == 1);
+}
+
+TEST_CASE("Socket backend reconnects when the device drops the connection") {
+    TcpSink sink{true};
+    SocketBackendOptions opts;
+    opts.port = sink.port();
+    SocketBackend backend{opts};
+    Job job{"label"};
+
+    REQUIRE(backend.print(job, "one"));
+    wait_for(sink, 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(backend.print(job, "two"));
+    wait_for(sink, 6);
+
+    REQUIRE(sink.received() == "onetwo");
+    REQUIRE(backend.stats().connects == 2);
+}
+
+TEST_CASE("Socket backend reports unreachable devices") {
+    SocketBackendOptions opts;
+    opts.port = 1;
+    opts.connect_timeout = std::chrono::milliseconds(200);
+    SocketBackend backend{opts};
+    Job job{"label"};
+    REQUIRE_FALSE(backend.print(job, "x"));
+    REQUIRE(backend.stats().failures == 1);
+}
+
+TEST_CASE("Socket backend writes a batch in one stream") {
+    TcpSink sink;
+    SocketBackendOptions opts;
+    opts.port = sink.port();
+    opts.trailer = "\f";
+    SocketBackend backend{opts};
+
+    Job a{"a"}, b{"b"}, c{"c"};
+    PrintItem items[] = {{&a, "A"}, {&b, "B"}, {&c, "C"}};
+    backend.print_batch(items);
+    wait_for(sink, 6);
+
+    REQUIRE(items[0].ok);
+    REQUIRE(items[1].ok);
+    REQUIRE(items[2].ok);
+    REQUIRE(sink.received() == "A\fB\fC\f");
+    REQUIRE(backend.stats().connects == 1);
+}
+
+TEST_CASE("Socket backend bounds the whole write of a slowly drained document") {
+    // The device keeps accepting a trickle of bytes, so every single stall
+    // is short; the write as a whole must still give up after write_timeout.
+    TcpSink sink{false, std::chrono::milliseconds(1)};
+    SocketBackendOptions opts;
+    opts.port = sink.port();
+    opts.write_timeout = std::chrono::milliseconds(300);
+    SocketBackend backend{opts};
+    Job job{"label"};
+
+    const std::string payload(64u << 20, 'x');
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(backend.print(job, payload));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(elapsed >= std::chrono::milliseconds(300));
+    REQUIRE(elapsed < std::chrono::seconds(5));
+    REQUIRE(backend.stats().failures == 1);
+}
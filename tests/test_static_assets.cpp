@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/static_assets.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace printpipe;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+class WebRoot {
+public:
+    WebRoot() : dir_(fs::temp_directory_path() / "printpipe-test-web") {
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+    ~WebRoot() { fs::remove_all(dir_); }
+
+    void write(const std::string& relative, const std::string& text) const {
+        const fs::path file = dir_ / relative;
+        fs::create_directories(file.parent_path());
+        std::ofstream(file, std::ios::binary) << text;
+    }
+
+    const fs::path& path() const { return dir_; }
+
+private:
+    fs::path dir_;
+};
+
+std::string script(std::size_t lines) {
+    std::string js;
+    for (std::size_t i = 0; i < lines; ++i) js += "console.log('printpipe line " + std::to_string(i) + "');\n";
+    return js;
+}
+
+} // namespace
+
+TEST_CASE("Static assets load from disk and map directories to index.html") {
+    WebRoot root;
+    root.write("index.html", "<h1>jobs</h1>");
+    root.write("js/app.js", script(4));
+    root.write("docs/index.html", "<p>docs</p>");
+    root.write(".git/config", "hidden");
+
+    StaticAssets assets(root.path());
+    REQUIRE(assets.reload() == 3);
+
+    auto index = assets.find("/");
+    REQUIRE(index);
+    REQUIRE(index->body == "<h1>jobs</h1>");
+    REQUIRE(index->content_type == "text/html; charset=utf-8");
+
+    REQUIRE(assets.find("/js/app.js")->content_type == "text/javascript; charset=utf-8");
+    REQUIRE(assets.find("/docs")->body == "<p>docs</p>");
+    REQUIRE(assets.find("/docs/")->body == "<p>docs</p>");
+    REQUIRE_FALSE(assets.find("/.git/config"));
+    REQUIRE_FALSE(assets.find("/missing.css"));
+}
+
+TEST_CASE("Static asset ETags are quoted and change with content") {
+    WebRoot root;
+    root.write("app.js", script(50));
+    StaticAssets assets(root.path());
+    assets.reload();
+
+    auto before = assets.find("/app.js");
+    REQUIRE(before->etag.size() == 18);
+    REQUIRE(before->etag.front() == '"');
+    REQUIRE(before->etag.back() == '"');
+
+    if (StaticAssets::gzip_supported()) {
+        REQUIRE(before->gzip.size() < before->body.size());
+        REQUIRE(static_cast<unsigned char>(before->gzip[0]) == 0x1f);
+        REQUIRE(static_cast<unsigned char>(before->gzip[1]) == 0x8b);
+        REQUIRE(before->gzip_etag != before->etag);
+    }
+
+    root.write("app.js", script(51));
+    assets.reload();
+    auto after = assets.find("/app.js");
+    REQUIRE(after->etag != before->etag);
+    // Requests already holding the old version keep it
+    REQUIRE(before->body == script(50));
+}
+
+TEST_CASE("Small and binary assets are not precompressed") {
+    WebRoot root;
+    root.write("tiny.css", "body{}");
+    root.write("logo.png", std::string(4096, '\0'));
+    StaticAssets assets(root.path());
+    assets.reload();
+
+    REQUIRE(assets.find("/tiny.css")->gzip.empty());
+    REQUIRE(assets.find("/logo.png")->gzip.empty());
+    REQUIRE(assets.find("/logo.png")->content_type == "image/png");
+}
+
+#if defined(__linux__)
+TEST_CASE("Watched static assets reload after files change") {
+    WebRoot root;
+    root.write("index.html", "v1");
+    StaticAssets assets(root.path());
+    assets.reload();
+    REQUIRE(assets.watch());
+
+    root.write("index.html", "v2");
+    root.write("new.js", "1;");
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline &&
+           (assets.find("/")->body != "v2" || !assets.find("/new.js"))) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(assets.find("/")->body == "v2");
+    REQUIRE(assets.find("/new.js"));
+}
+#endif
+
+TEST_CASE("If-None-Match and Accept-Encoding parsing") {
+    REQUIRE(etag_matches("\"abc\"", "\"abc\""));
+    REQUIRE(etag_matches("\"x\", \"abc\"", "\"abc\""));
+    REQUIRE(etag_matches("W/\"abc\"", "\"abc\""));
+    REQUIRE(etag_matches("*", "\"abc\""));
+    REQUIRE_FALSE(etag_matches("", "\"abc\""));
+    REQUIRE_FALSE(etag_matches("\"abcd\"", "\"abc\""));
+
+    REQUIRE(accepts_gzip("gzip, deflate, br"));
+    REQUIRE(accepts_gzip("br;q=1.0, gzip;q=0.8"));
+    REQUIRE(accepts_gzip("*"));
+    REQUIRE_FALSE(accepts_gzip(""));
+    REQUIRE_FALSE(accepts_gzip("br, deflate"));
+    REQUIRE_FALSE(accepts_gzip("gzip;q=0"));
+    REQUIRE_FALSE(accepts_gzip("gzip;q=0.000"));
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/timer_wheel.hpp"
+
+#include <algorithm>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+TEST_CASE("Timer wheel fires items when due, never early") {
+    const auto t0 = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel{10ms, t0};
+
+    wheel.schedule(1, t0 + 15ms);
+    wheel.schedule(2, t0 + 700ms);     // level 1
+    wheel.schedule(3, t0 + 50s);       // level 2
+    REQUIRE(wheel.size() == 3);
+
+    std::vector<int> out;
+    wheel.advance(t0 + 10ms, out);
+    REQUIRE(out.empty());
+    wheel.advance(t0 + 20ms, out);
+    REQUIRE(out == std::vector<int>{1});
+
+    wheel.advance(t0 + 690ms, out);
+    REQUIRE(out.size() == 1);
+    wheel.advance(t0 + 700ms, out);
+    REQUIRE(out == std::vector<int>{1, 2});
+
+    wheel.advance(t0 + 49990ms, out);
+    REQUIRE(out.size() == 2);
+    wheel.advance(t0 + 50s, out);
+    REQUIRE(out == std::vector<int>{1, 2, 3});
+    REQUIRE(wheel.empty());
+}
+
+TEST_CASE("Timer wheel reports the next deadline") {
+    const auto t0 = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel{10ms, t0};
+
+    REQUIRE_FALSE(wheel.next_due());
+    wheel.schedule(7, t0 + 30ms);
+    REQUIRE(*wheel.next_due() == t0 + 30ms);
+
+    std::vector<int> out;
+    wheel.advance(*wheel.next_due(), out);
+    REQUIRE(out == std::vector<int>{7});
+}
+
+TEST_CASE("Timer wheel handles many timers spread over levels") {
+    const auto t0 = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel{1ms, t0};
+
+    for (int i = 0; i < 5000; ++i) wheel.schedule(i, t0 + std::chrono::milliseconds(i * 37 % 300000));
+
+    std::vector<int> out;
+    wheel.advance(t0 + 300s, out);
+    REQUIRE(out.size() == 5000);
+    std::sort(out.begin(), out.end());
+    REQUIRE(std::adjacent_find(out.begin(), out.end()) == out.end());
+}
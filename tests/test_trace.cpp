@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+#include "printpipe/scheduler.hpp"
+#include "printpipe/trace.hpp"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+
+using namespace printpipe;
+using namespace std::chrono_literals;
+
+namespace {
+
+class NullBackend final : public IBackend {
+public:
+    bool print(const Job&, std::string_view) override { return true; }
+};
+
+// Tracing is process-wide; leave it off for the other tests.
+struct TracingOn {
+    TracingOn() { trace::set_enabled(true); }
+    ~TracingOn() { trace::set_enabled(false); }
+};
+
+std::size_t count_named(const std::vector<trace::Span>& spans, std::string_view name) {
+    return static_cast<std::size_t>(std::count_if(spans.begin(), spans.end(),
+                                                  [&](const trace::Span& s) { return s.name == name; }));
+}
+
+} // namespace
+
+TEST_CASE("Trace spans are recorded only while enabled") {
+    const char* name = trace::intern("test.enabled");
+    {
+        trace::Scope span(name);
+    }
+    REQUIRE(count_named(trace::collect(), "test.enabled") == 0);
+
+    TracingOn on;
+    {
+        trace::Scope span(name, 777001);
+        std::this_thread::sleep_for(1ms);
+    }
+    const auto spans = trace::collect(777001);
+    REQUIRE(spans.size() == 1);
+    REQUIRE(spans.front().name == name);
+    REQUIRE(spans.front().dur_ns >= 1000000);
+}
+
+TEST_CASE("Trace rings keep the newest spans per thread") {
+    TracingOn on;
+    const char* name = trace::intern("test.ring");
+    std::thread([&] {
+        for (std::size_t i = 0; i < trace::kRingCapacity + 100; ++i) trace::record(name, 0, 1, 2);
+    }).join();
+    // collect() also skips the oldest slot, which a live writer could be reusing
+    REQUIRE(count_named(trace::collect(), "test.ring") == trace::kRingCapacity - 1);
+}
+
+TEST_CASE("Scheduler traces each job's stages") {
+    TracingOn on;
+    Scheduler sched;
+    sched.set_backend(std::make_shared<NullBackend>());
+    sched.start();
+
+    auto job = std::make_shared<Job>("traced");
+    job->set_payload(std::string("x"));
+    REQUIRE(sched.submit(job));
+    REQUIRE(job->wait_terminal(2s) == JobState::Completed);
+    sched.stop();
+
+    const auto spans = trace::collect(job->id());
+    std::set<std::string_view> names;
+    for (const auto& s : spans) names.insert(s.name);
+    REQUIRE(names == std::set<std::string_view>{"queue_wait", "spool", "print"});
+
+    const auto json = trace::to_chrome_json(spans);
+    REQUIRE(json.find("\"name\":\"spool\",\"cat\":\"job\",\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(json.find("\"args\":{\"job_id\":" + std::to_string(job->id()) + "}") != std::string::npos);
+}